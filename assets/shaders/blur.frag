@@ -0,0 +1,40 @@
+#version 430 core
+
+out vec4 FragColor;
+
+uniform sampler2D tex;  //the texture being blurred
+uniform vec2 halfPixel; //half the size of a texel of the texture being written to, in uv coordinates
+uniform bool upsample;  //whether this is an upsample pass or a downsample pass
+in vec2 texCoord;
+
+void main()
+{
+	//dual kawase filter (from https://community.arm.com/cfs-file/__key/communityserver-blogs-components-weblogfiles/00-00-00-20-66/siggraph2015_2D00_mmg_2D00_marius_2D00_notes.pdf):
+	//---------------------------------
+	vec4 sum;
+	if(upsample)
+	{
+		sum  = texture(tex, texCoord + vec2(-halfPixel.x * 2.0, 0.0));
+		sum += texture(tex, texCoord + vec2(-halfPixel.x, halfPixel.y)) * 2.0;
+		sum += texture(tex, texCoord + vec2(0.0, halfPixel.y * 2.0));
+		sum += texture(tex, texCoord + vec2(halfPixel.x, halfPixel.y)) * 2.0;
+		sum += texture(tex, texCoord + vec2(halfPixel.x * 2.0, 0.0));
+		sum += texture(tex, texCoord + vec2(halfPixel.x, -halfPixel.y)) * 2.0;
+		sum += texture(tex, texCoord + vec2(0.0, -halfPixel.y * 2.0));
+		sum += texture(tex, texCoord + vec2(-halfPixel.x, -halfPixel.y)) * 2.0;
+		sum /= 12.0;
+	}
+	else
+	{
+		sum  = texture(tex, texCoord) * 4.0;
+		sum += texture(tex, texCoord - halfPixel);
+		sum += texture(tex, texCoord + halfPixel);
+		sum += texture(tex, texCoord + vec2(halfPixel.x, -halfPixel.y));
+		sum += texture(tex, texCoord - vec2(halfPixel.x, -halfPixel.y));
+		sum /= 8.0;
+	}
+
+	//return:
+	//---------------------------------
+	FragColor = sum;
+}
\ No newline at end of file
@@ -9,29 +9,188 @@ uniform float cornerRad; //the radius of the corner rounding
 uniform vec4 outlineColor;
 uniform float outlineThickness;
 
+#define MAX_SHAPE_POINTS 32
+
+uniform int shape;                          //0 = rect, 1 = circle, 2 = arc, 3 = line, 4 = triangle, 5 = polyline
+uniform vec4 shapeParams;                   //circle: {radius}, arc: {radius, half thickness, start angle, end angle}, line + polyline: {half thickness}
+uniform vec2 shapePoints[MAX_SHAPE_POINTS]; //the points of lines, triangles and polylines, in pixels relative to the center
+uniform int shapeNumPoints;                 //the number of points in a polyline
+
+uniform bool premultiplied; //whether to output premultiplied alpha, textures are then also assumed to be premultiplied
+
 uniform bool useTex; 	 //whether or not to sample a texture
 uniform sampler2D tex; 	 //the texture to sample
 in vec2 texCoord; 		 //the texture coordinate
 
+uniform bool useNineSlice; //whether or not to nine-slice the texture
+uniform vec4 sliceInsets;  //the texture's border insets, in texels ({left, right, top, bottom})
+uniform float sliceScale;  //the number of pixels each border texel takes up on screen
+
+uniform bool useBlur;        //whether or not to draw the blurred framebuffer behind the rect
+uniform sampler2D blurTex;   //the blurred framebuffer
+uniform vec2 screenSize;     //the size of the framebuffer, in pixels
+uniform float blurOpacity;   //the opacity of the blurred background
+
+#define MAX_GRADIENT_STOPS 8
+
+uniform int gradientType;                                //0 = no gradient, 1 = linear, 2 = radial
+uniform vec2 gradientStart;                              //the start point (linear) or center (radial) of the gradient, in uv coordinates
+uniform vec2 gradientEnd;                                //the end point (linear) or a point on the outer edge (radial) of the gradient, in uv coordinates
+uniform int gradientNumStops;                            //the number of color stops
+uniform vec4 gradientColors[MAX_GRADIENT_STOPS];         //the color of each stop
+uniform float gradientPositions[MAX_GRADIENT_STOPS];     //the position of each stop along the gradient, in increasing order
+
+//distance functions (from https://iquilezles.org/articles/distfunctions2d/):
+float segment_dist(vec2 p, vec2 a, vec2 b)
+{
+	vec2 pa = p - a, ba = b - a;
+	float h = clamp(dot(pa, ba) / max(dot(ba, ba), 0.0001), 0.0, 1.0);
+	return length(pa - ba * h);
+}
+
+float triangle_dist(vec2 p, vec2 p0, vec2 p1, vec2 p2)
+{
+	vec2 e0 = p1 - p0, e1 = p2 - p1, e2 = p0 - p2;
+	vec2 v0 = p  - p0, v1 = p  - p1, v2 = p  - p2;
+	vec2 pq0 = v0 - e0 * clamp(dot(v0, e0) / dot(e0, e0), 0.0, 1.0);
+	vec2 pq1 = v1 - e1 * clamp(dot(v1, e1) / dot(e1, e1), 0.0, 1.0);
+	vec2 pq2 = v2 - e2 * clamp(dot(v2, e2) / dot(e2, e2), 0.0, 1.0);
+	float s = sign(e0.x * e2.y - e0.y * e2.x);
+	vec2 d = min(min(vec2(dot(pq0, pq0), s * (v0.x * e0.y - v0.y * e0.x)),
+	                 vec2(dot(pq1, pq1), s * (v1.x * e1.y - v1.y * e1.x))),
+	                 vec2(dot(pq2, pq2), s * (v2.x * e2.y - v2.y * e2.x)));
+	return -sqrt(d.x) * sign(d.y);
+}
+
+float arc_dist(vec2 p, float radius, float halfThickness, float startAngle, float endAngle)
+{
+	//rotate so the arc is centered on the x axis:
+	float mid = (startAngle + endAngle) * 0.5;
+	float halfAperture = abs(endAngle - startAngle) * 0.5;
+	p = mat2(cos(mid), -sin(mid), sin(mid), cos(mid)) * p;
+
+	if(abs(atan(p.y, p.x)) <= halfAperture)
+		return abs(length(p) - radius) - halfThickness;
+
+	vec2 cap = radius * vec2(cos(halfAperture), sin(halfAperture));
+	return length(vec2(p.x, abs(p.y)) - cap) - halfThickness;
+}
+
+float shape_dist()
+{
+	vec2 p = (texCoord - 0.5) * size;
+
+	switch(shape)
+	{
+	case 1:
+		return length(p) - shapeParams.x;
+	case 2:
+		return arc_dist(p, shapeParams.x, shapeParams.y, shapeParams.z, shapeParams.w);
+	case 3:
+		return segment_dist(p, shapePoints[0], shapePoints[1]) - shapeParams.x;
+	case 4:
+		return triangle_dist(p, shapePoints[0], shapePoints[1], shapePoints[2]) - cornerRad;
+	case 5:
+	{
+		float dist = segment_dist(p, shapePoints[0], shapePoints[1]);
+		for(int i = 2; i < shapeNumPoints; i++)
+			dist = min(dist, segment_dist(p, shapePoints[i - 1], shapePoints[i]));
+
+		return dist - shapeParams.x;
+	}
+	default:
+	{
+		vec2 d = abs(p) - (size * 0.5 - cornerRad);
+		return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0) - cornerRad;
+	}
+	}
+}
+
+vec2 nine_slice_coord()
+{
+	vec2 texSize = vec2(textureSize(tex, 0));
+	vec2 pos = texCoord * size;
+
+	//find border sizes, shrinking them if they don't fit:
+	vec2 borderMin = sliceInsets.xw * sliceScale;
+	vec2 borderMax = sliceInsets.yz * sliceScale;
+	vec2 fit = min(vec2(1.0), size / max(borderMin + borderMax, 0.0001));
+	borderMin *= fit;
+	borderMax *= fit;
+
+	vec2 uvMin = sliceInsets.xw / texSize;
+	vec2 uvMax = sliceInsets.yz / texSize;
+
+	//corners and edges keep their size, the center stretches:
+	vec2 centerAlpha = (pos - borderMin) / max(size - borderMin - borderMax, 0.0001);
+	vec2 uv = uvMin + centerAlpha * (1.0 - uvMin - uvMax);
+	uv = mix(uv, pos / max(borderMin, 0.0001) * uvMin, lessThan(pos, borderMin));
+	uv = mix(uv, 1.0 - (size - pos) / max(borderMax, 0.0001) * uvMax, greaterThan(pos, size - borderMax));
+
+	return uv;
+}
+
+vec4 premultiply(vec4 col)
+{
+	return premultiplied ? vec4(col.rgb * col.a, col.a) : col;
+}
+
+vec4 gradient_color()
+{
+	//find position along gradient (done in pixels so radial gradients stay circular):
+	vec2 pos   = texCoord      * size;
+	vec2 start = gradientStart * size;
+	vec2 end   = gradientEnd   * size;
+
+	float t;
+	if(gradientType == 1)
+		t = dot(pos - start, end - start) / max(dot(end - start, end - start), 0.0001);
+	else
+		t = length(pos - start) / max(length(end - start), 0.0001);
+
+	//blend between stops:
+	vec4 result = premultiply(gradientColors[0]);
+	for(int i = 1; i < gradientNumStops; i++)
+	{
+		float stopAlpha = clamp((t - gradientPositions[i - 1]) / max(gradientPositions[i] - gradientPositions[i - 1], 0.0001), 0.0, 1.0);
+		result = mix(result, premultiply(gradientColors[i]), stopAlpha);
+	}
+
+	return result;
+}
+
 void main()
 {
 	//set color:
 	//---------------------------------
-	vec4 finalColor = color;
+	vec4 finalColor = premultiply(color);
+	if(gradientType != 0)
+		finalColor *= gradient_color();
 	if(useTex)
-		finalColor *= texture(tex, texCoord);
+		finalColor *= texture(tex, useNineSlice ? nine_slice_coord() : texCoord);
+
+	if(useBlur) //color acts as a tint over the blurred background
+	{
+		vec3 blurColor = texture(blurTex, gl_FragCoord.xy / screenSize).rgb;
+		if(premultiplied)
+			finalColor = vec4(blurColor * (1.0 - finalColor.a) + finalColor.rgb, 1.0) * blurOpacity;
+		else
+			finalColor = vec4(mix(blurColor, finalColor.rgb, finalColor.a), blurOpacity);
+	}
 
-	//check distance (from https://iquilezles.org/articles/distfunctions2d/):
+	//check distance:
 	//---------------------------------
-	vec2 d = abs((texCoord - 0.5) * size) - (size * 0.5 - cornerRad);
-	float dist = length(max(d, 0.0)) + min(max(d.x, d.y), 0.0) - cornerRad;
+	float dist = shape_dist();
 
 	//check if should be outlined:
 	//---------------------------------
 	float outlineA = smoothstep(-outlineThickness, -outlineThickness + 2.0, dist);
-	finalColor = mix(finalColor, outlineColor, outlineA);
+	finalColor = mix(finalColor, premultiply(outlineColor), outlineA);
 
-	finalColor.a *= smoothstep(1.0, -1.0, dist);
+	if(premultiplied)
+		finalColor *= smoothstep(1.0, -1.0, dist);
+	else
+		finalColor.a *= smoothstep(1.0, -1.0, dist);
 
 	//return:
 	//---------------------------------
@@ -1,26 +1,34 @@
 #version 430 core
 
-in vec2 texCoord;
+in vec3 texCoord;
+flat in vec4 color;
+flat in vec4 outlineColor;
+flat in vec4 params;
 out vec4 FragColor;
 
 uniform sampler2D textureAtlas;
+uniform sampler2DArray textureArray;
+uniform bool useArray; //whether to sample textureArray, for fonts loaded with DNUI_FONT_TEXTURE_ARRAY
 
-uniform vec4 color;
-uniform float scale;
-uniform float thickness;
-uniform float softness;
+uniform bool premultiplied; //whether to output premultiplied alpha
+uniform bool msdf;          //whether the atlas holds multi-channel distance fields
 
-uniform vec4 outlineColor;
-uniform float outlineThickness;
-uniform float outlineSoftness;
+float median(vec3 v)
+{
+	return max(min(v.r, v.g), min(max(v.r, v.g), v.b));
+}
 
 void main()
 {
-	float dist = texture(textureAtlas, texCoord).r;
+	vec3 texel = useArray ? texture(textureArray, texCoord).rgb : texture(textureAtlas, texCoord.xy).rgb;
+	float dist = msdf ? median(texel) : texel.r;
 	
-	float a = smoothstep(thickness - softness / scale, thickness + softness / scale, dist);
-	float outlineA = smoothstep(outlineThickness - outlineSoftness / scale, outlineThickness + outlineSoftness / scale, dist);
+	float a = smoothstep(params.x - params.y, params.x + params.y, dist);
+	float outlineA = smoothstep(params.z - params.w, params.z + params.w, dist);
 
 	vec4 finalColor = mix(outlineColor, color, outlineA);
-	FragColor = vec4(finalColor.rgb, finalColor.a * a);
+	if(premultiplied)
+		FragColor = vec4(finalColor.rgb * finalColor.a, finalColor.a) * a;
+	else
+		FragColor = vec4(finalColor.rgb, finalColor.a * a);
 }
\ No newline at end of file
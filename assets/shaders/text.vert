@@ -0,0 +1,24 @@
+#version 430 core
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec3 inTexCoord; //z is the layer, for fonts in a texture array
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in vec4 inOutlineColor;
+layout(location = 4) in vec4 inParams;   //thickness, softness, outline thickness, outline softness, with the softnesses already divided by the text's scale
+
+out vec3 texCoord;
+flat out vec4 color;
+flat out vec4 outlineColor;
+flat out vec4 params;
+
+uniform mat3 modelProjection;
+
+void main()
+{
+	vec3 pos = modelProjection * vec3(inPos, 1.0);
+	gl_Position = vec4(pos.xy, 0.0, 1.0);
+	texCoord = inTexCoord;
+	color = inColor;
+	outlineColor = inOutlineColor;
+	params = inParams;
+}
\ No newline at end of file
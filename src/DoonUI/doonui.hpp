@@ -13,5 +13,6 @@
 #include "elements/colorselector.hpp"
 #include "elements/textbox.hpp"
 #include "elements/checkbox.hpp"
+#include "elements/textlog.hpp"
 
 #endif
\ No newline at end of file
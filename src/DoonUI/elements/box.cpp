@@ -17,6 +17,13 @@ void dnui::Box::render(float parentAlphaMult)
 	DNvec4 renderCol = {m_color.x, m_color.y, m_color.z, m_color.w * m_alphaMult * parentAlphaMult};
 	DNvec4 renderOutlineCol = {m_outlineColor.x, m_outlineColor.y, m_outlineColor.z, m_outlineColor.w * m_alphaMult * parentAlphaMult};
 
-	DNUI_draw_rect(m_texture, m_renderPos, m_renderSize, m_angle, renderCol, m_cornerRadius, renderOutlineCol, m_outlineThickness);
+	if(m_blurBehind)
+		DNUI_draw_rect_blurred(m_renderPos, m_renderSize, m_angle, m_color, m_alphaMult * parentAlphaMult, m_cornerRadius, renderOutlineCol, m_outlineThickness);
+	else if(m_texture >= 0 && (m_sliceInsets.x > 0.0f || m_sliceInsets.y > 0.0f || m_sliceInsets.z > 0.0f || m_sliceInsets.w > 0.0f))
+		DNUI_draw_rect_nine_slice(m_texture, m_sliceInsets, m_sliceScale, m_renderPos, m_renderSize, m_angle, renderCol, m_cornerRadius, renderOutlineCol, m_outlineThickness);
+	else if(m_gradient.type != DNUI_GRADIENT_NONE)
+		DNUI_draw_rect_gradient(m_texture, &m_gradient, m_renderPos, m_renderSize, m_angle, renderCol, m_cornerRadius, renderOutlineCol, m_outlineThickness);
+	else
+		DNUI_draw_rect(m_texture, m_renderPos, m_renderSize, m_angle, renderCol, m_cornerRadius, renderOutlineCol, m_outlineThickness);
 	dnui::Element::render(parentAlphaMult);
 }
\ No newline at end of file
@@ -16,6 +16,10 @@ public:
 	float m_angle = 0.0f;                             //the box's rotation, in degrees
 	DNvec4 m_outlineColor = {0.0f, 0.0f, 0.0f, 1.0f}; //the box's outline color
 	float m_outlineThickness = 0.0f;                  //the box's outline thickness, in pixels
+	bool m_blurBehind = false;                        //whether the box should blur what is behind it, m_color will then tint the blur, and m_texture is ignored
+	DNUIgradient m_gradient = {};                     //the gradient to fill the box with, gets multiplied by m_color. The stops can be animated with offsetof(Box, m_gradient.colors[i])
+	DNvec4 m_sliceInsets = {0.0f, 0.0f, 0.0f, 0.0f};  //the texture's nine-slice borders, in texels ({left, right, top, bottom}). Set all to 0 to stretch the whole texture. Takes priority over m_gradient
+	float m_sliceScale = 1.0f;                        //the number of pixels each nine-slice border texel takes up on screen
 
 	Box() = default;
 	Box(Coordinate x, Coordinate y, Dimension w, Dimension h, 
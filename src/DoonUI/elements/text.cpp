@@ -24,21 +24,28 @@ dnui::Text::Text(Coordinate x, Coordinate y, Dimension size, std::string txt,
 
 void dnui::Text::update(float dt, DNvec2 parentPos, DNvec2 parentSize)
 {
+	//fonts loaded with DNUI_load_font_async() can't be measured until they're ready, so the last size is kept:
+	if(!DNUI_font_ready(m_font))
+	{
+		dnui::Element::update(dt, parentPos, parentSize);
+		return;
+	}
+
 	m_height.type = Dimension::PIXELS;
 	if(m_lineWrap <= 0.0f)
 	{
 		if(m_scale <= 0.0f)
-			m_renderScale = m_renderSize.x / DNUI_string_render_size(m_text.c_str(), m_font, 1.0f, 0.0f).x;
+			m_renderScale = m_renderSize.x / measure(1.0f, 0.0f).x;
 		else
 		{
 			m_renderScale = m_scale;
 
 			m_width.type = Dimension::PIXELS;
-			m_width.pixelSize = DNUI_string_render_size(m_text.c_str(), m_font, m_renderScale, 0.0f).x;
+			m_width.pixelSize = measure(m_renderScale, 0.0f).x;
 		}
 
 		m_renderW = 0.0f;
-		m_height.pixelSize = m_font->atlasH * m_renderScale;
+		m_height.pixelSize = m_font->lineHeight * m_renderScale;
 	}
 	else
 	{
@@ -48,7 +55,7 @@ void dnui::Text::update(float dt, DNvec2 parentPos, DNvec2 parentSize)
 			m_renderScale = m_scale;
 
 		m_renderW = m_renderSize.x;
-		m_height.pixelSize = DNUI_string_render_size(m_text.c_str(), m_font, m_renderScale, m_renderW).y;
+		m_height.pixelSize = measure(m_renderScale, m_renderW).y;
 	}
 
 	dnui::Element::update(dt, parentPos, parentSize);
@@ -58,8 +65,22 @@ void dnui::Text::render(float parentAlphaMult)
 {
 	DNvec4 renderCol = {m_color.x, m_color.y, m_color.z, m_color.w * m_alphaMult * parentAlphaMult};
 	DNvec4 outlineRenderCol = {m_outlineColor.x, m_outlineColor.y, m_outlineColor.z, m_outlineColor.w * m_alphaMult * parentAlphaMult};
-	if(m_font != nullptr)
-		DNUI_draw_string(m_text.c_str(), m_font, m_renderPos, m_renderScale, m_renderW, m_align, renderCol, m_thickness, m_softness, outlineRenderCol, m_outlineThickness, m_outlineSoftness);
+	if(m_font != nullptr && DNUI_font_ready(m_font))
+		DNUI_draw_string_n(m_text.data(), m_text.size(), m_font, m_renderPos, m_renderScale, m_renderW, m_align, renderCol, m_thickness, m_softness, outlineRenderCol, m_outlineThickness, m_outlineSoftness);
 
 	dnui::Element::render(parentAlphaMult);
+}
+
+DNvec2 dnui::Text::measure(float scale, float maxW)
+{
+	if(m_font != m_measuredFont || scale != m_measuredScale || maxW != m_measuredW || m_text != m_measuredText)
+	{
+		m_measuredText = m_text;
+		m_measuredFont = m_font;
+		m_measuredScale = scale;
+		m_measuredW = maxW;
+		m_measuredSize = DNUI_string_render_size_n(m_text.data(), m_text.size(), m_font, scale, maxW);
+	}
+
+	return m_measuredSize;
 }
\ No newline at end of file
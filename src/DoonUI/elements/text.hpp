@@ -40,6 +40,15 @@ public:
 protected:
 	float m_renderScale; //the final scale of text
 	float m_renderW;     //the final maximum line width of the text, in pixels
+
+	//the inputs and result of the last measurement, so labels that don't change aren't measured again:
+	std::string m_measuredText;
+	DNUIfont* m_measuredFont = nullptr;
+	float m_measuredScale = 0.0f;
+	float m_measuredW = -1.0f;
+	DNvec2 m_measuredSize;
+
+	DNvec2 measure(float scale, float maxW); //returns DNUI_string_render_size() of the text, reusing the last result if nothing changed
 };
 
 }; //namespace dnui
@@ -44,12 +44,24 @@ void dnui::TextBox::set_control_key_state(bool shiftHeld, bool ctrlHeld)
 
 std::string dnui::TextBox::get_highlighted()
 {
+	return std::string(get_highlighted_view());
+}
+
+std::string_view dnui::TextBox::get_highlighted_view()
+{
+	std::string_view text = m_text;
 	if(m_highlightLen == 0)
-		return m_text;
+		return text;
 	else if(m_highlightLen < 0)
-		return m_text.substr(m_cursorPos + m_highlightLen, -m_highlightLen);
+	{
+		size_t start = get_byte_pos(m_cursorPos + m_highlightLen);
+		return text.substr(start, get_byte_pos(m_cursorPos) - start);
+	}
 	else
-		return m_text.substr(m_cursorPos, m_highlightLen);
+	{
+		size_t start = get_byte_pos(m_cursorPos);
+		return text.substr(start, get_byte_pos(m_cursorPos + m_highlightLen) - start);
+	}
 }
 
 void dnui::TextBox::update(float dt, DNvec2 parentPos, DNvec2 parentSize)
@@ -58,8 +70,8 @@ void dnui::TextBox::update(float dt, DNvec2 parentPos, DNvec2 parentSize)
 	m_time += dt;
 
 	//get text render scale:
-	m_charPositons.resize(m_text.length());
-	m_textSize = DNUI_line_render_size(m_text.c_str(), m_font, 1.0f, m_charPositons.data());
+	m_charPositons.resize(DNUI_utf8_length_n(m_text.data(), m_text.size()));
+	m_textSize = DNUI_line_render_size_n(m_text.data(), m_text.size(), m_font, 1.0f, m_charPositons.data());
 
 	DNvec2 expectedTextSize = DN_vec2_sub(m_renderSize, {2.0f * m_textPadding, 2.0f * m_textPadding});
 	float expectedAspect = expectedTextSize.x / expectedTextSize.y;
@@ -145,7 +157,7 @@ void dnui::TextBox::render(float parentAlphaMult)
 	DNvec2 renderPos = {m_renderPos.x - m_renderSize.x * 0.5f + m_textSize.x * m_renderScale * 0.5f + m_textPadding, m_renderPos.y};
 	DNvec4 renderCol = {m_textColor.x, m_textColor.y, m_textColor.z, m_textColor.w * m_alphaMult * parentAlphaMult};
 	DNvec4 outlineRenderCol = {m_textOutlineColor.x, m_textOutlineColor.y, m_textOutlineColor.z, m_textOutlineColor.w * m_alphaMult * parentAlphaMult};
-	DNUI_draw_string(m_text.c_str(), m_font, renderPos, m_renderScale, 0.0f, 0, renderCol, m_textThickness, 0.05f, outlineRenderCol, m_textOutlineThickness, 0.05f);
+	DNUI_draw_string_n(m_text.data(), m_text.size(), m_font, renderPos, m_renderScale, 0.0f, 0, renderCol, m_textThickness, 0.05f, outlineRenderCol, m_textOutlineThickness, 0.05f);
 
 	m_cursor->render(m_alphaMult * parentAlphaMult);
 	m_highlight->render(m_alphaMult * parentAlphaMult);
@@ -165,7 +177,7 @@ void dnui::TextBox::handle_event(Event event)
 		switch(event.arrowKey.dir)
 		{
 		case 0:
-			if(m_cursorPos < m_text.length())
+			if(m_cursorPos < DNUI_utf8_length_n(m_text.data(), m_text.size()))
 			{
 				m_cursorPos++;
 				m_highlightLen--;
@@ -179,7 +191,7 @@ void dnui::TextBox::handle_event(Event event)
 			}
 			break;
 		case 2:
-			m_cursorPos = m_text.length();
+			m_cursorPos = DNUI_utf8_length_n(m_text.data(), m_text.size());
 			m_highlightLen = oldCursorPos - m_cursorPos;
 			break;
 		case 3:
@@ -234,12 +246,12 @@ void dnui::TextBox::handle_event(Event event)
 			}
 			else
 			{
-				if(m_cursorPos < m_text.length())
+				if(m_cursorPos < DNUI_utf8_length_n(m_text.data(), m_text.size()))
 					endPos++;
 			}
 		}
 
-		m_text = m_text.substr(0, startPos) + m_text.substr(endPos);
+		m_text = m_text.substr(0, get_byte_pos(startPos)) + m_text.substr(get_byte_pos(endPos));
 		m_highlightLen = 0;
 		break;
 	}
@@ -267,7 +279,9 @@ void dnui::TextBox::handle_event(Event event)
 			endPos = m_cursorPos;
 		}
 
-		m_text = m_text.substr(0, startPos) + (char)event.character.character + m_text.substr(endPos);
+		char encoded[4];
+		int encodedLen = DNUI_utf8_encode(event.character.character, encoded);
+		m_text = m_text.substr(0, get_byte_pos(startPos)) + std::string(encoded, encodedLen) + m_text.substr(get_byte_pos(endPos));
 		m_cursorPos++;
 		m_highlightLen = 0;
 		break;
@@ -286,7 +300,7 @@ float dnui::TextBox::get_cursor_render_pos(int cursorPos)
 
 	if(cursorPos == 0)
 		result = m_charPositons[cursorPos].x * m_renderScale;
-	else if(cursorPos == m_text.length())
+	else if(cursorPos == m_charPositons.size())
 	{
 		result = m_charPositons[cursorPos - 1].y * m_renderScale;
 	}
@@ -316,5 +330,15 @@ int dnui::TextBox::get_cursor_pos(float cursorRenderPos)
 			return i;
 	}
 
-	return m_text.length();
+	return m_charPositons.size();
+}
+
+size_t dnui::TextBox::get_byte_pos(int cursorPos)
+{
+	size_t pos = 0;
+	uint32_t codepoint;
+	for(int i = 0; i < cursorPos && pos < m_text.length(); i++)
+		pos += DNUI_utf8_decode_n(&m_text[pos], m_text.length() - pos, &codepoint);
+
+	return pos;
 }
\ No newline at end of file
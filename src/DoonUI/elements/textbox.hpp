@@ -4,6 +4,7 @@
 #include "../element.hpp"
 #include "box.hpp"
 #include <string>
+#include <string_view>
 
 namespace dnui
 {
@@ -27,7 +28,7 @@ public:
 	float m_textPadding = 10.0f;                          //space between edge of background and start of text, in pixels
 
 	//info:
-	int m_cursorPos = 0;     //the index of the character the cursor is on
+	int m_cursorPos = 0;     //the index of the character (codepoint) the cursor is on
 	int m_highlightLen = 0;  //the number of characters highlighted
 
 	TextBox() = default;
@@ -48,6 +49,8 @@ public:
 
 	//returns the highlighted portion of the text, or the entire string if none is highlighted
 	std::string get_highlighted();
+	//same as get_highlighted(), but refers to the text instead of copying it, so it can be measured or drawn with the _n text functions. Invalidated when the text changes
+	std::string_view get_highlighted_view();
 
 	void update(float dt, DNvec2 parentPos, DNvec2 parentSize);
 	void render(float parentAlphaMult);
@@ -69,6 +72,8 @@ private:
 	float get_cursor_render_pos(int cursorPos);
 	//returns the position of the cursor in the text, given its rendered position
 	int get_cursor_pos(float cursorRenderPos); 
+	//returns the position in m_text of the cursor's utf-8 encoded character, since the cursor is positioned in codepoints
+	size_t get_byte_pos(int cursorPos);
 
 	int m_lastCursorPos = 0;     //the cursor position last frame, used to determine if an animation update is needed
 	int m_orgCursorPos = 0;      //original cursor position when highlighting started
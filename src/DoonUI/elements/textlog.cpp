@@ -0,0 +1,275 @@
+#include "textlog.hpp"
+
+dnui::TextLog::TextLog(Coordinate x, Coordinate y, Dimension w, Dimension h,
+	DNUIfont* fnt, int maxLines, DNvec4 col, float scl, bool smoothScroll) : dnui::Element(x, y, w, h)
+{
+	m_font = fnt;
+	m_maxLines = maxLines > 0 ? maxLines : 1;
+	m_color = col;
+	m_scale = scl;
+	m_smoothScroll = smoothScroll;
+}
+
+void dnui::TextLog::add_line(std::string text)
+{
+	Line line = {std::move(text), -1.0f, 0.0f, 0.0, false};
+	if(m_numLines < m_maxLines)
+	{
+		if((int)m_lines.size() < m_maxLines)
+			m_lines.push_back(std::move(line));
+		else
+			line_at(m_numLines) = std::move(line);
+
+		m_numLines++;
+	}
+	else
+	{
+		//replace the oldest line, the rest keep their tops:
+		if(m_lines[m_firstLine].stale)
+			m_numStale--;
+
+		m_lines[m_firstLine] = std::move(line);
+		m_firstLine = (m_firstLine + 1) % m_maxLines;
+		if(m_numMeasured > 0)
+			m_numMeasured--;
+	}
+}
+
+void dnui::TextLog::clear()
+{
+	m_lines.clear();
+	m_firstLine = 0;
+	m_numLines = 0;
+	m_numMeasured = 0;
+	m_numStale = 0;
+	m_totalHeight = 0.0;
+	m_scrollPos = 0.0f;
+	m_scrollTargetPos = 0.0f;
+}
+
+void dnui::TextLog::update(float dt, DNvec2 parentPos, DNvec2 parentSize)
+{
+	//the log's size doesn't depend on its lines, so it's updated first and lines are wrapped at the current size:
+	dnui::Element::update(dt, parentPos, parentSize);
+
+	//fonts loaded with DNUI_load_font_async() can't be measured until they're ready:
+	if(m_font == nullptr || !DNUI_font_ready(m_font))
+		return;
+
+	//if scrolled up, the line at the top of the view stays there while lines are added or wrapped again:
+	int anchor = -1;
+	double anchorOffset = 0.0;
+	if(m_scrollTargetPos > 0.0f && m_numMeasured > 0)
+	{
+		anchor = first_line_below(m_viewTop);
+		if(anchor < m_numMeasured)
+			anchorOffset = line_at(anchor).top - m_viewTop;
+		else
+			anchor = -1;
+	}
+
+	//place lines added since the last update, or every line if their wrapping changed. Lines are only estimated here, so the cost doesn't depend on
+	//the length of the history:
+	//---------------------------------
+	if(m_font != m_measuredFont || m_scale != m_measuredScale || m_renderSize.x != m_measuredW)
+	{
+		if(m_font != m_measuredFont)
+			for(int i = 0; i < m_numLines; i++)
+				line_at(i).width = -1.0f;
+
+		m_measuredFont = m_font;
+		m_measuredScale = m_scale;
+		m_measuredW = m_renderSize.x;
+
+		m_numMeasured = 0;
+		m_totalHeight = m_numLines > 0 ? line_at(0).top : 0.0;
+	}
+
+	for(int i = m_numMeasured; i < m_numLines; i++)
+	{
+		Line& line = line_at(i);
+		line.top = m_totalHeight;
+		measure_line(line, false);
+		m_totalHeight += line.height;
+	}
+
+	m_numMeasured = m_numLines;
+
+	//update scrolling:
+	//---------------------------------
+	place_view(anchor, anchorOffset);
+
+	if(m_smoothScroll)
+		m_scrollPos += (m_scrollTargetPos - m_scrollPos) * (1.0f - powf(0.99f, dt));
+	else
+		m_scrollPos = m_scrollTargetPos;
+
+	place_view(-1, 0.0);
+
+	//measure the lines in view, then a few more starting from the newest, keeping the view on the same line:
+	//---------------------------------
+	if(m_numStale == 0)
+		return;
+
+	if(m_scrollTargetPos > 0.0f)
+	{
+		anchor = first_line_below(m_viewTop);
+		anchorOffset = anchor < m_numLines ? line_at(anchor).top - m_viewTop : 0.0;
+		anchor = anchor < m_numLines ? anchor : -1;
+	}
+
+	//measuring the view can bring more lines into it, if the estimates were too tall:
+	while(measure_view())
+		place_view(anchor, anchorOffset);
+
+	int first = m_numLines;
+	int budget = m_measuresPerFrame;
+	for(int i = m_numLines - 1; i >= 0 && budget > 0 && m_numStale > 0; i--)
+	{
+		Line& line = line_at(i);
+		if(!line.stale)
+			continue;
+
+		measure_line(line, true);
+		first = i;
+		budget--;
+	}
+
+	if(first < m_numLines)
+	{
+		update_tops(first);
+		place_view(anchor, anchorOffset);
+	}
+}
+
+void dnui::TextLog::render(float parentAlphaMult)
+{
+	if(m_font == nullptr || !DNUI_font_ready(m_font) || m_numMeasured == 0)
+	{
+		dnui::Element::render(parentAlphaMult);
+		return;
+	}
+
+	DNvec4 renderCol = {m_color.x, m_color.y, m_color.z, m_color.w * m_alphaMult * parentAlphaMult};
+	DNvec4 outlineRenderCol = {m_outlineColor.x, m_outlineColor.y, m_outlineColor.z, m_outlineColor.w * m_alphaMult * parentAlphaMult};
+
+	//draw from the first line below the top of the view until a line doesn't fit, lines are only drawn if they're entirely inside the log:
+	//---------------------------------
+	float left = m_renderPos.x - m_renderSize.x * 0.5f;
+	float top = m_renderPos.y + m_renderSize.y * 0.5f;
+	for(int i = first_line_below(m_viewTop); i < m_numMeasured; i++)
+	{
+		Line& line = line_at(i);
+		float y = (float)(line.top - m_viewTop);
+		if(y + line.height > m_renderSize.y)
+			break;
+
+		bool wrapped = line.width * m_scale > m_measuredW;
+		float w = wrapped ? m_measuredW : line.width * m_scale;
+		DNvec2 pos = {left + w * 0.5f, top - y - line.height * 0.5f};
+		DNUI_draw_string_n(line.text.data(), line.text.size(), m_font, pos, m_scale, wrapped ? m_measuredW : 0.0f, 0, renderCol, m_thickness, m_softness, outlineRenderCol, m_outlineThickness, m_outlineSoftness);
+	}
+
+	dnui::Element::render(parentAlphaMult);
+}
+
+void dnui::TextLog::handle_event(Event event)
+{
+	if(event.type == Event::SCROLL && m_active && is_hovered() && m_font != nullptr)
+		m_scrollTargetPos += event.scroll.dir * m_scrollLines * m_font->lineHeight * m_scale;
+
+	dnui::Element::handle_event(event);
+}
+
+int dnui::TextLog::first_line_below(double y)
+{
+	//lines are sorted by their tops:
+	int first = 0;
+	int last = m_numMeasured;
+	while(first < last)
+	{
+		int mid = (first + last) / 2;
+		if(line_at(mid).top < y)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	return first;
+}
+
+void dnui::TextLog::measure_line(Line& line, bool exact)
+{
+	if(line.stale)
+		m_numStale--;
+
+	//lines narrower than the log are never wrapped, so only their width is needed, which doesn't change with the log's size:
+	if(line.width < 0.0f && exact)
+		line.width = DNUI_line_render_size_n(line.text.data(), line.text.size(), m_font, 1.0f, nullptr).x;
+
+	float lineHeight = m_font->lineHeight * m_scale;
+	if(line.width >= 0.0f && line.width * m_scale <= m_measuredW)
+		line.height = lineHeight;
+	else if(exact)
+		line.height = DNUI_string_render_size_n(line.text.data(), line.text.size(), m_font, m_scale, m_measuredW).y;
+	else if(line.width >= 0.0f && m_measuredW > 0.0f)
+		line.height = ceilf(line.width * m_scale / m_measuredW) * lineHeight; //wrapping only ever adds lines, so this is close
+	else
+		line.height = lineHeight;
+
+	line.stale = !exact && (line.width < 0.0f || line.width * m_scale > m_measuredW);
+	if(line.stale)
+		m_numStale++;
+}
+
+bool dnui::TextLog::measure_view()
+{
+	//measures every stale line in view, returning whether any were:
+	int first = m_numLines;
+	for(int i = first_line_below(m_viewTop); i < m_numLines && line_at(i).top - m_viewTop < m_renderSize.y; i++)
+	{
+		Line& line = line_at(i);
+		if(!line.stale)
+			continue;
+
+		measure_line(line, true);
+		first = first < i ? first : i;
+	}
+
+	if(first == m_numLines)
+		return false;
+
+	update_tops(first);
+	return true;
+}
+
+void dnui::TextLog::update_tops(int first)
+{
+	double top = line_at(first).top;
+	for(int i = first; i < m_numLines; i++)
+	{
+		line_at(i).top = top;
+		top += line_at(i).height;
+	}
+
+	m_totalHeight = top;
+}
+
+void dnui::TextLog::place_view(int anchor, double anchorOffset)
+{
+	//moves the scroll position so the anchor line is anchorOffset pixels below the top of the view, then clamps it:
+	float logHeight = m_numLines > 0 ? (float)(m_totalHeight - line_at(0).top) : 0.0f;
+	float maxScroll = fmaxf(logHeight - m_renderSize.y, 0.0f);
+	if(anchor >= 0)
+	{
+		float scroll = (float)(line_at(0).top + maxScroll - (line_at(anchor).top - anchorOffset));
+		m_scrollTargetPos += scroll - m_scrollPos;
+		m_scrollPos = scroll;
+	}
+
+	m_scrollTargetPos = fminf(fmaxf(m_scrollTargetPos, 0.0f), maxScroll);
+	m_scrollPos = fminf(fmaxf(m_scrollPos, 0.0f), maxScroll);
+
+	if(m_numLines > 0)
+		m_viewTop = line_at(0).top + fmaxf(maxScroll - m_scrollPos, 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef TEXTLOG_H
+#define TEXTLOG_H
+
+#include "../element.hpp"
+#include <string>
+
+namespace dnui
+{
+
+//a scrolling log of lines of text, like a chat or console. Only the lines that are scrolled into view are drawn, so it can keep a long history
+//without getting slower. Lines wider than the log wrap, the newest line is at the bottom
+class TextLog : public Element
+{
+public:
+	//text parameters:
+	DNUIfont* m_font = nullptr;                //the handle to the font to render with
+	DNvec4 m_color = {1.0f, 1.0f, 1.0f, 1.0f}; //the text's color
+	float m_scale = 1.0f;                      //the scale of the text
+	float m_thickness = 0.5f;                  //the thickness of the text
+	float m_softness = 0.05f;                  //the softness of the text's edges
+
+	//outline parameters:
+	DNvec4 m_outlineColor = {0.0f, 0.0f, 0.0f, 0.0f}; //the color of the text's outline
+	float m_outlineThickness = 1.0f;                  //the thickness at which the text's outline begins
+	float m_outlineSoftness = 0.05f;                  //the softness of the outline's edges
+
+	float m_scrollLines = 3.0f;   //the number of lines scrolled per step of the scroll wheel
+	bool m_smoothScroll = false;  //whether or not to smooth out the scrolling of the log
+	int m_measuresPerFrame = 256; //the most lines measured per update outside of the view. Lines that haven't been yet, such as after the log is resized, use an estimated height
+
+	TextLog() = default;
+	TextLog(Coordinate x, Coordinate y, Dimension w, Dimension h,
+		DNUIfont* font, int maxLines = 10000, DNvec4 color = {1.0f, 1.0f, 1.0f, 1.0f},
+		float scale = 1.0f, bool smoothScroll = false);
+
+	/* Adds a line to the bottom of the log, removing the oldest line if the log already has its maximum number of lines.
+	 * If the log is scrolled up, it stays on the same lines instead of moving down to the new one
+	 * @param text the line to add, in utf-8
+	 */
+	void add_line(std::string text);
+	//removes every line from the log
+	void clear();
+
+	//returns the number of lines in the log
+	int get_num_lines() { return m_numLines; }
+	//returns a line of the log, index 0 being the oldest
+	const std::string& get_line(int index) { return line_at(index).text; }
+
+	void update(float dt, DNvec2 parentPos, DNvec2 parentSize);
+	void render(float parentAlphaMult);
+	void handle_event(Event event);
+
+protected:
+	struct Line
+	{
+		std::string text;
+		float width;  //the width of the line without wrapping, at a scale of 1.0. Negative until measured
+		float height; //the height of the line once wrapped, in pixels
+		double top;   //the total height of every line before this one, lines are positioned by subtracting the oldest's
+		bool stale;   //whether height is only an estimate, until the line is measured at the current width
+	};
+
+	std::vector<Line> m_lines; //a ring buffer of up to m_maxLines lines, grows until it's full
+	int m_maxLines = 10000;
+	int m_firstLine = 0;       //the index in m_lines of the oldest line
+	int m_numLines = 0;
+	int m_numMeasured = 0;     //lines are placed in update(), this many of the oldest lines have their height and top set
+	int m_numStale = 0;        //the number of lines with an estimated height
+	double m_totalHeight = 0.0; //the top of the next line to be placed
+
+	//the parameters heights were measured with, they're measured again when these change:
+	DNUIfont* m_measuredFont = nullptr;
+	float m_measuredScale = 0.0f;
+	float m_measuredW = 0.0f;
+
+	float m_scrollPos = 0.0f;       //how far the log is scrolled up from the newest line, in pixels
+	float m_scrollTargetPos = 0.0f; //the target scroll position
+	double m_viewTop = 0.0;         //the top of the log's visible area, in the same space as the lines' tops
+
+	Line& line_at(int index) { return m_lines[(m_firstLine + index) % m_maxLines]; }
+	int first_line_below(double y);
+	void measure_line(Line& line, bool exact);
+	bool measure_view();
+	void update_tops(int first);
+	void place_view(int anchor, double anchorOffset);
+};
+
+}; //namespace dnui
+
+#endif
\ No newline at end of file
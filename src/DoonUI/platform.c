@@ -0,0 +1,255 @@
+#ifndef _WIN32
+	#define _XOPEN_SOURCE 700 //for PTHREAD_MUTEX_RECURSIVE
+#endif
+
+#include "platform.h"
+
+#include <malloc.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+struct _DNUIthread
+{
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+
+	void (*func)(void*);
+	void* arg;
+};
+
+struct _DNUImutex
+{
+#ifdef _WIN32
+	CRITICAL_SECTION handle;
+#else
+	pthread_mutex_t handle;
+#endif
+};
+
+struct _DNUIfileMapping
+{
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#endif
+
+	const void* data;
+	size_t size;
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+#ifdef _WIN32
+static DWORD WINAPI _DNUI_thread_start(LPVOID data)
+{
+	_DNUIthread* thread = data;
+	thread->func(thread->arg);
+	return 0;
+}
+#else
+static void* _DNUI_thread_start(void* data)
+{
+	_DNUIthread* thread = data;
+	thread->func(thread->arg);
+	return NULL;
+}
+#endif
+
+_DNUIthread* _DNUI_thread_create(void (*func)(void*), void* arg)
+{
+	_DNUIthread* thread = malloc(sizeof(_DNUIthread));
+	if(!thread)
+		return NULL;
+
+	thread->func = func;
+	thread->arg = arg;
+
+#ifdef _WIN32
+	thread->handle = CreateThread(NULL, 0, _DNUI_thread_start, thread, 0, NULL);
+	if(thread->handle == NULL)
+#else
+	if(pthread_create(&thread->handle, NULL, _DNUI_thread_start, thread) != 0)
+#endif
+	{
+		free(thread);
+		return NULL;
+	}
+
+	return thread;
+}
+
+void _DNUI_thread_join(_DNUIthread* thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+
+	free(thread);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+_DNUImutex* _DNUI_mutex_create()
+{
+	_DNUImutex* mutex = malloc(sizeof(_DNUImutex));
+	if(!mutex)
+		return NULL;
+
+#ifdef _WIN32
+	InitializeCriticalSection(&mutex->handle);
+#else
+	//recursive, like critical sections:
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	int result = pthread_mutex_init(&mutex->handle, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	if(result != 0)
+	{
+		free(mutex);
+		return NULL;
+	}
+#endif
+
+	return mutex;
+}
+
+void _DNUI_mutex_destroy(_DNUImutex* mutex)
+{
+#ifdef _WIN32
+	DeleteCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_destroy(&mutex->handle);
+#endif
+
+	free(mutex);
+}
+
+void _DNUI_mutex_lock(_DNUImutex* mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void _DNUI_mutex_unlock(_DNUImutex* mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+unsigned int _DNUI_get_core_count()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (unsigned int)count : 1;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+_DNUIfileMapping* _DNUI_map_file(const char* path, const void** data, size_t* size)
+{
+	_DNUIfileMapping* mapping = malloc(sizeof(_DNUIfileMapping));
+	if(!mapping)
+		return NULL;
+
+#ifdef _WIN32
+	mapping->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(mapping->file == INVALID_HANDLE_VALUE)
+	{
+		free(mapping);
+		return NULL;
+	}
+
+	LARGE_INTEGER fileSize;
+	mapping->mapping = NULL;
+	mapping->data = NULL;
+	if(GetFileSizeEx(mapping->file, &fileSize) && fileSize.QuadPart > 0)
+	{
+		mapping->size = (size_t)fileSize.QuadPart;
+		mapping->mapping = CreateFileMappingA(mapping->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(mapping->mapping)
+			mapping->data = MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	if(!mapping->data)
+	{
+		if(mapping->mapping)
+			CloseHandle(mapping->mapping);
+		CloseHandle(mapping->file);
+		free(mapping);
+		return NULL;
+	}
+#else
+	int file = open(path, O_RDONLY);
+	if(file < 0)
+	{
+		free(mapping);
+		return NULL;
+	}
+
+	//the mapping stays valid after the file is closed:
+	struct stat fileInfo;
+	mapping->data = MAP_FAILED;
+	if(fstat(file, &fileInfo) == 0 && fileInfo.st_size > 0)
+	{
+		mapping->size = (size_t)fileInfo.st_size;
+		mapping->data = mmap(NULL, mapping->size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+
+	close(file);
+
+	if(mapping->data == MAP_FAILED)
+	{
+		free(mapping);
+		return NULL;
+	}
+#endif
+
+	*data = mapping->data;
+	*size = mapping->size;
+	return mapping;
+}
+
+void _DNUI_unmap_file(_DNUIfileMapping* mapping)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(mapping->data);
+	CloseHandle(mapping->mapping);
+	CloseHandle(mapping->file);
+#else
+	munmap((void*)mapping->data, mapping->size);
+#endif
+
+	free(mapping);
+}
\ No newline at end of file
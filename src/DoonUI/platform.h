@@ -0,0 +1,66 @@
+#ifndef DNUI_PLATFORM_H
+#define DNUI_PLATFORM_H
+
+//platform-specific utilities used internally by DNUI, not part of the public API
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+//THREADS:
+
+typedef struct _DNUIthread _DNUIthread;
+typedef struct _DNUImutex _DNUImutex;
+
+/* Starts a new thread
+ * @param func the function for the thread to run
+ * @param arg the argument to pass to func
+ * @returns the new thread, or NULL on failure
+ */
+_DNUIthread* _DNUI_thread_create(void (*func)(void*), void* arg);
+/* Waits for a thread to finish, then frees it
+ * @param thread the thread to wait for
+ */
+void _DNUI_thread_join(_DNUIthread* thread);
+
+/* @returns a new mutex, or NULL on failure. Mutexes are recursive, the thread holding one can lock it again
+ */
+_DNUImutex* _DNUI_mutex_create();
+/* Frees a mutex, must not be locked
+ */
+void _DNUI_mutex_destroy(_DNUImutex* mutex);
+void _DNUI_mutex_lock(_DNUImutex* mutex);
+void _DNUI_mutex_unlock(_DNUImutex* mutex);
+
+/* @returns the number of logical cores available
+ */
+unsigned int _DNUI_get_core_count();
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+//FILES:
+
+typedef struct _DNUIfileMapping _DNUIfileMapping;
+
+/* Maps a file into memory as read-only
+ * @param path the path to the file
+ * @param data populated with a pointer to the file's contents, valid until the file is unmapped
+ * @param size populated with the size of the file, in bytes
+ * @returns the mapping, or NULL on failure
+ */
+_DNUIfileMapping* _DNUI_map_file(const char* path, const void** data, size_t* size);
+/* Unmaps a file mapped with _DNUI_map_file()
+ */
+void _DNUI_unmap_file(_DNUIfileMapping* mapping);
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
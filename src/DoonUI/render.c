@@ -1,19 +1,44 @@
 #include "render.h"
+#include "platform.h"
+#include "sdf.h"
 
 #include <stdio.h>
 #include <ctype.h>
 #include <malloc.h>
 #include <math.h>
 #include <string.h>
+#include <stddef.h>
 #include <GLAD/glad.h>
 #include <FreeType/ft2build.h>
 #include FT_FREETYPE_H
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define DNUI_MEASURE_AVX2
+	#define DNUI_MEASURE_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DNUI_MEASURE_SSE2
+#endif
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 
-static bool _DNUI_load_into_buffer(const char* path, char** buffer);
+static bool _DNUI_load_into_buffer(const char* path, char** buffer, size_t* size);
 static bool _DNUI_load_shader_program(const char* vertPath, const char* fragPath, GLuint* program);
 
+static void _DNUI_set_rect_uniforms(int textureHandle, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+static void _DNUI_draw_shape(int shape, const DNvec2* points, int numPoints, float padding, DNvec4 params, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+static void _DNUI_create_blur_targets(unsigned int w, unsigned int h);
+static void _DNUI_generate_blur();
+static void _DNUI_flush_text();
+static DNvec2 _DNUI_layout_text(const char* text, int len, DNUIfont* font, float scale, float maxW, int align, DNUItextLayout* layout);
+static float _DNUI_layout_line(const char* text, int start, int end, DNUIfont* font, float scale, DNUItextLayout* layout);
+static void _DNUI_align_layout(DNUItextLayout* layout, int align);
+static void _DNUI_draw_layout(const DNUItextLayout* layout, DNUIfont* font, float scale, DNvec2 pos, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness);
+static void _DNUI_font_worker(void* data);
+
 //--------------------------------------------------------------------------------------------------------------------------------//
 //for rendering text:
 
@@ -21,7 +46,342 @@ static GLuint textProgram;
 static GLuint textBuffer;
 static GLuint textArray;
 
+//a vertex of a glyph's quad, each carries the style of its string so strings with different styles can be drawn in one call
+typedef struct _DNUItextVertex
+{
+	GLfloat x, y;
+	GLfloat texX, texY, layer;
+	DNvec4 color;
+	DNvec4 outlineColor;
+	GLfloat thickness, softness, outlineThickness, outlineSoftness; //the softnesses are divided by the string's scale
+} _DNUItextVertex;
+
+static _DNUItextVertex* textBatch = NULL; //the glyphs queued to be drawn, all sampling from textBatchTexture
+static int textBatchSize = 0;
+static int textBatchCapacity = 0;
+static GLuint textBatchTexture = 0;
+static unsigned int textBatchFlags = 0;   //the DNUI_FONT_* flags of the fonts in the batch
+static bool textBatching = false;         //whether DNUI_begin_text_batch() was called, otherwise the batch is drawn after every string
+
+#define DNUI_LAYOUT_CACHE_SIZE 4096    //the number of strings whose size and layout are cached, the least recently used are replaced once it's full
+#define DNUI_LAYOUT_CACHE_BUCKETS 8192 //the size of the cache's hash table, must be a power of 2
+
+//where a string can break and how wide it is up to each character, at the shared font's size. Doesn't depend on the scale or wrap width,
+//so the string can be wrapped again at any width by walking over its words instead of measuring every character
+typedef struct _DNUIlineBreaks
+{
+	int numChars;
+	int* offsets;      //the byte offset of each character, followed by the text's length
+	float* pen;        //the pen position before each character (the sum of every previous character's kerning and advance), followed by the position after the last
+	float* right;      //the right edge of each character's bitmap, after kerning with the previous character
+
+	int numWords;      //words are runs of characters that aren't spaces, lines only break at their start or, if a word doesn't fit on a line by itself, inside them
+	int* wordStarts;   //the first character of each word
+	int* wordEnds;     //the character after the last of each word
+	float* wordRights; //the largest right edge of each word's characters
+
+	int charCapacity, wordCapacity; //the allocated size of the arrays
+} _DNUIlineBreaks;
+
+//a recently measured or drawn string, cached so strings that don't change aren't laid out again every frame
+typedef struct _DNUIlayoutCacheEntry
+{
+	uint32_t hash;
+	char* text;      //NULL if the entry is unused
+	int len;
+	DNUIfont* font;  //the shared font
+	bool lineBreaks; //whether the entry holds the string's breaks instead of a size and layout, these are found once per string and font, ignoring the scale and wrap width
+	float scale;     //the scale relative to the shared font
+	float maxW;
+
+	DNvec2 size;
+	bool hasLayout; //whether layout has been filled in, measuring only needs the size
+	int align;      //the alignment layout's lines are positioned for
+	DNUItextLayout layout;
+	_DNUIlineBreaks breaks;
+	bool pinned;    //set while drawing from the entry with the cache unlocked, so it isn't replaced
+
+	int bucketNext;       //the next entry in the same bucket (or free list), -1 if last
+	int lruPrev, lruNext; //the neighbouring entries in the lru list, which goes from most to least recently used
+} _DNUIlayoutCacheEntry;
+
+static _DNUImutex* layoutCacheMutex = NULL;       //created with the first font, since strings can be measured from any thread
+static _DNUIlayoutCacheEntry* layoutCache = NULL; //DNUI_LAYOUT_CACHE_SIZE entries, allocated on first use. Unused entries keep their layout's arrays to be reused
+static int* layoutCacheBuckets = NULL;            //the first entry in each bucket, -1 if empty
+static int numLayoutCacheEntries = 0;             //the number of entries that have been used, the rest are untouched
+static int layoutCacheFree = -1;                  //the first unused entry, linked through bucketNext
+static int layoutCacheFirst = -1;                 //the most recently used entry
+static int layoutCacheLast = -1;                  //the least recently used entry, replaced when the cache is full
+
+static _DNUIlayoutCacheEntry* _DNUI_get_cached_layout(const char* text, int len, DNUIfont* font, bool lineBreaks, float scale, float maxW, bool create);
+static void _DNUI_remove_cached_layout(int index);
+static void _DNUI_clear_cached_layouts(DNUIfont* font);
+static void _DNUI_unlink_cached_layout(int index);
+static void _DNUI_push_cached_layout(int index);
+
+static const _DNUIlineBreaks* _DNUI_get_line_breaks(const char* text, int len, DNUIfont* font);
+static void _DNUI_find_line_breaks(const char* text, int len, DNUIfont* font, _DNUIlineBreaks* breaks);
+static int _DNUI_next_line_break(const _DNUIlineBreaks* breaks, int start, bool skipFirst, float scale, float maxW, int* word);
+
+//a texture array shared by every font with DNUI_FONT_TEXTURE_ARRAY and the same atlas format, each font's atlas sits in the top left of its own layer
+typedef struct _DNUIfontArray
+{
+	GLuint texture;
+	int w, h;      //the size of every layer, at least the size of the largest atlas in the array
+	int numLayers; //the number of layers allocated, layers are reused once their font is freed
+} _DNUIfontArray;
+
+static _DNUIfontArray fontArrays[3]; //one for each atlas format, see _DNUI_get_font_array()
+
 static FT_Library freetypeLib;
+static bool glInitialized = false; //whether DNUI_init() was called, fonts can be loaded for their metrics without it
+
+static bool _DNUI_init_freetype();
+
+#define DNUI_MAX_FONT_WORKERS 64 //the maximum number of threads used to render a font's glyphs
+
+static unsigned int fontLoadThreads = 0; //the number of threads used to render a font's glyphs, 0 to use one per core
+
+static DNUIfont** fontCache = NULL; //every shared font currently loaded, so loading a file again reuses its glyphs
+static int numCachedFonts = 0;
+static int maxCachedFonts = 0;
+
+//a font file mapped into memory, shared by every face loaded from it so it's only read once, and only the pages freetype touches are resident
+typedef struct _DNUIfontFile
+{
+	char* path;
+	_DNUIfileMapping* mapping;
+	const unsigned char* data;
+	size_t size;
+	int refCount; //the number of faces (and bakes) using the file, it is unmapped when this reaches 0
+} _DNUIfontFile;
+
+static _DNUImutex* fontFileMutex = NULL; //guards the list below, since fonts loaded with DNUI_load_font_async() open files from their load thread
+static _DNUIfontFile** fontFiles = NULL;
+static int numFontFiles = 0;
+static int maxFontFiles = 0;
+
+static _DNUIfontFile* _DNUI_open_font_file(const char* path);
+static void _DNUI_close_font_file(_DNUIfontFile* file);
+
+static _DNUImutex* fontLoadMutex = NULL; //guards the queue below, created by the first DNUI_load_font_async()
+static DNUIfont** finishedFontLoads = NULL; //fonts whose load thread has finished, waiting for DNUI_begin_frame() to upload their atlas
+static int numFinishedFontLoads = 0;
+static int maxFinishedFontLoads = 0;
+
+//a glyph rendered by a font worker, before being copied into the atlas
+typedef struct _DNUIglyphBitmap
+{
+	bool loaded;
+	int worker;      //the worker whose arena holds the bitmap
+	size_t arenaPos; //the position of the bitmap in the worker's arena
+	float advance;
+	unsigned int w, h;
+	int l, t;
+	int atlasX, atlasY; //the bitmap's position in the atlas, set when packed
+} _DNUIglyphBitmap;
+
+//renders the glyphs first, first + stride, first + 2 * stride, ... of a list of codepoints
+typedef struct _DNUIfontWorker
+{
+	FT_Library lib; //the library to use, or NULL to create one for this worker
+	const unsigned char* fontData;
+	size_t fontDataSize;
+	int faceIndex;
+	int size;
+	unsigned int flags; //the DNUI_FONT_* flags the font is being loaded with
+	const uint32_t* codepoints;
+	int numCodepoints;
+	int first, stride;
+
+	_DNUIglyphBitmap* glyphs; //one per codepoint, shared between all workers, each only writes to the glyphs it renders
+	unsigned char* arena;     //the worker's rendered bitmaps
+	size_t arenaSize;
+	bool failed;
+} _DNUIfontWorker;
+
+static bool _DNUI_get_glyph_metrics(FT_Face face, FT_UInt glyphIndex, unsigned int flags, _DNUIrenderedGlyph* glyph);
+static int _DNUI_get_atlas_channels(unsigned int flags);
+static GLenum _DNUI_get_atlas_format(unsigned int flags);
+static bool _DNUI_wants_compressed_atlas(unsigned int flags);
+static bool _DNUI_use_compressed_atlas(unsigned int flags);
+static size_t _DNUI_get_compressed_atlas_size(int w, int h);
+static void _DNUI_compress_atlas(const unsigned char* image, int imageW, int imageH, int x, int y, int w, int h, unsigned char* blocks);
+static void _DNUI_decompress_atlas(const unsigned char* blocks, int w, int h, unsigned char* image);
+
+#define DNUI_ATLAS_PADDING 1 //the empty space left between glyphs in font atlases, in pixels
+
+//a glyph's bitmap to be packed into a font atlas
+typedef struct _DNUIatlasRect
+{
+	int glyph;
+	int w, h;
+	int x, y; //the bitmap's position in the atlas, set when packed
+} _DNUIatlasRect;
+
+typedef struct _DNUIskylineNode
+{
+	int x, y, w;
+} _DNUIskylineNode;
+
+//a skyline rect packer, tracks the top edge of the packed area as a list of horizontal segments
+typedef struct _DNUIskyline
+{
+	int w, h;
+	int numNodes, maxNodes;
+	_DNUIskylineNode* nodes; //sorted by x, always covering the full width
+} _DNUIskyline;
+
+static int _DNUI_compare_atlas_rects(const void* a, const void* b);
+static bool _DNUI_pack_atlas(_DNUIatlasRect* rects, int numRects, int w, int* h, _DNUIskyline* skyline);
+static void _DNUI_skyline_init(_DNUIskyline* skyline, int w, int h);
+static void _DNUI_skyline_free(_DNUIskyline* skyline);
+static bool _DNUI_skyline_insert(_DNUIskyline* skyline, int w, int h, int* x, int* y);
+
+#define DNUI_MIN_GLYPH_TABLE_SIZE 256   //the initial size of a font's glyph hash table, must be a power of 2
+#define DNUI_MAX_FONT_ATLAS_SIZE 4096   //font atlases grow up to this size (or the maximum texture size) before glyphs start getting evicted
+#define DNUI_REPLACEMENT_CHARACTER 0xFFFD //the codepoint invalid utf-8 sequences decode to
+#define DNUI_KERNING_TABLE_SIZE 128     //kerning between codepoints below this is stored in a dense table, other pairs are cached in a hash table. Their metrics are also kept in dense arrays
+#define DNUI_MEASURE_BLOCK_SIZE 64      //the number of characters _DNUI_measure_ascii() gathers before summing, must be a multiple of 8
+
+static int maxFontAtlasSize = DNUI_MAX_FONT_ATLAS_SIZE; //lowered to the maximum texture size by DNUI_init(), cached so atlases can be packed off the openGL thread
+
+//a kerning adjustment between two codepoints, cached in a font's kerning hash table
+typedef struct _DNUIkerningPair
+{
+	uint32_t left, right;
+	float x; //the horizontal adjustment between the pair, in pixels
+	bool used;
+} _DNUIkerningPair;
+
+//the parts of a font only used internally
+typedef struct _DNUIfontInternal
+{
+	int size;
+	unsigned int flags; //the DNUI_FONT_* flags the font was loaded with
+	char* path;         //the file the font was loaded from and the face within it, used as the font cache's key
+	int faceIndex;
+	DNUIfont** handles; //every handle to the font, it is freed when the last one is
+	int numHandles, maxHandles;
+	int numFaces;
+	FT_Face faces[DNUI_MAX_FALLBACK_FONTS + 1];   //the primary face, followed by any fallback faces in the order they are checked
+	_DNUIfontFile* faceFiles[DNUI_MAX_FALLBACK_FONTS + 1]; //the file each face reads from, must stay open for the face's lifetime
+	_DNUImutex* mutex;  //held while the glyph table, kerning cache or faces are used, so text can be measured from other threads
+
+	_DNUIskyline skyline;      //the free space in the atlas
+	unsigned char* atlasImage; //a copy of the atlas' contents, used when repacking, with _DNUI_get_atlas_channels() bytes per pixel
+	bool baked;                //whether the font was loaded from a baked file, baked fonts have no faces and never change their atlas
+
+	bool loading;              //whether the font was loaded with DNUI_load_font_async() and isn't ready yet, only changed on the openGL thread
+	bool loadFailed;           //set by the load thread, the font is never ready if it failed
+	_DNUIthread* loadThread;   //loads the faces, metrics and atlas image of an asynchronously loaded font
+	FT_Library lib;            //the library the load thread created the font's faces in, NULL if they were created in freetypeLib
+
+	float* asciiKerning;             //DNUI_KERNING_TABLE_SIZE * DNUI_KERNING_TABLE_SIZE adjustments indexed by [left][right], NULL if the font has no kerning
+	_DNUIkerningPair* kerningPairs;  //open-addressed hash table of every other pair looked up so far
+	unsigned int numKerningPairs;
+	unsigned int kerningCapacity;    //always a power of 2
+
+	//the metrics of codepoints below DNUI_KERNING_TABLE_SIZE, copied out of the glyph table into separate arrays so ascii text can be measured without looking glyphs up:
+	bool asciiMetricsLoaded;                      //filled the first time the font is measured
+	float asciiAdvances[DNUI_KERNING_TABLE_SIZE];
+	float asciiWidths[DNUI_KERNING_TABLE_SIZE];   //the width of each glyph's bitmap, in pixels
+	float asciiBearings[DNUI_KERNING_TABLE_SIZE]; //the position of the left edge of each glyph's bitmap, in pixels
+} _DNUIfontInternal;
+
+#define DNUI_BAKED_FONT_MAGIC "DNUF"
+#define DNUI_BAKED_FONT_VERSION 3 //must be incremented whenever the baked font format changes
+
+//baked font files are laid out as: header, glyphs, kerning pairs, atlas pixels (atlasW * atlasH pixels, row by row, or rgtc1 blocks if _DNUI_wants_compressed_atlas()). All values are little endian
+typedef struct _DNUIbakedFontHeader
+{
+	char magic[4];
+	uint32_t version;
+	int32_t size;
+	uint32_t flags; //the DNUI_FONT_* flags the font was baked with
+	float maxBearing;
+	float lineHeight;
+	uint32_t atlasW, atlasH;
+	uint32_t numGlyphs;
+	uint32_t numKerningPairs;
+} _DNUIbakedFontHeader;
+
+typedef struct _DNUIbakedGlyph
+{
+	uint32_t codepoint;
+	float advance;
+	float bmpW, bmpH;
+	float bmpL, bmpT;
+	int32_t atlasX, atlasY;
+} _DNUIbakedGlyph;
+
+typedef struct _DNUIbakedKerningPair
+{
+	uint32_t left, right;
+	float x; //the horizontal adjustment between the pair, in pixels
+} _DNUIbakedKerningPair;
+
+//a glyph index in the font being baked and the baked glyph that uses it, sorted by index so the kern table's pairs can be matched to baked glyphs
+typedef struct _DNUIbakedGlyphIndex
+{
+	FT_UInt index;
+	uint32_t glyph;
+} _DNUIbakedGlyphIndex;
+
+//a pair of baked glyphs read from a font's kern table
+typedef struct _DNUIkernTableEntry
+{
+	FT_UInt left, right;
+	uint32_t order; //entries for the same pair are combined in the order their subtables appear
+	int32_t value;  //in font units
+	bool override;  //whether the entry replaces the previous subtables' adjustment instead of adding to it
+} _DNUIkernTableEntry;
+
+static bool _DNUI_render_glyphs(FT_Library lib, const unsigned char* fontData, size_t fontDataSize, int faceIndex, int size, unsigned int flags, const uint32_t* codepoints, int numCodepoints, _DNUIglyphBitmap* glyphs, _DNUIfontWorker* workers, unsigned int* numWorkers);
+static unsigned char* _DNUI_pack_glyphs(_DNUIglyphBitmap* glyphs, int numGlyphs, const _DNUIfontWorker* workers, int channels, int maxSize, int* w, int* h, _DNUIskyline* skyline);
+static void _DNUI_get_line_metrics(const _DNUIglyphBitmap* glyphs, const uint32_t* codepoints, int numGlyphs, float* maxBearing, float* lineHeight);
+static void _DNUI_get_kerning_pairs(const unsigned char* fontData, size_t fontDataSize, int size, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs);
+static void _DNUI_read_kern_table(FT_Face face, FT_ULong tableSize, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs);
+static void _DNUI_scan_kerning_pairs(FT_Face face, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs);
+static void _DNUI_push_baked_kerning_pair(_DNUIbakedKerningPair** pairs, uint32_t* numPairs, uint32_t* maxPairs, uint32_t left, uint32_t right, float x);
+static int _DNUI_compare_baked_glyph_indices(const void* a, const void* b);
+static int _DNUI_compare_kern_table_entries(const void* a, const void* b);
+static uint32_t _DNUI_find_baked_glyph_index(const _DNUIbakedGlyphIndex* indices, uint32_t numIndices, FT_UInt index);
+static DNUIfont* _DNUI_create_font(int size, unsigned int numGlyphs);
+static DNUIfont* _DNUI_load_shared_font(const char* path, int faceIndex, int size, unsigned int flags);
+static bool _DNUI_load_font_faces(DNUIfont* font, FT_Library lib);
+static void _DNUI_font_load_thread(void* data);
+static void _DNUI_join_font_load(DNUIfont* font);
+static bool _DNUI_finish_font_load(DNUIfont* font);
+static void _DNUI_free_shared_font(DNUIfont* font);
+static DNUIfont* _DNUI_load_shared_baked_font(const char* path);
+static DNUIfont* _DNUI_create_font_handle(DNUIfont* shared, int size);
+static void _DNUI_update_font_handles(DNUIfont* shared);
+static bool _DNUI_render_atlas(DNUIfont* font, FT_Library lib);
+static bool _DNUI_create_atlas(DNUIfont* font);
+static GLuint _DNUI_create_atlas_texture(DNUIfont* font);
+static void _DNUI_upload_atlas(DNUIfont* font, const unsigned char* pixels);
+static void _DNUI_upload_atlas_data(DNUIfont* font, const unsigned char* data);
+static void _DNUI_update_atlas(DNUIfont* font, int x, int y, int w, int h);
+static _DNUIfontArray* _DNUI_get_font_array(unsigned int flags);
+static void _DNUI_resize_font_array(_DNUIfontArray* array, unsigned int flags, int w, int h, int numLayers);
+
+static DNUIglyph* _DNUI_find_glyph(DNUIfont* font, uint32_t codepoint);
+static void _DNUI_grow_glyph_table(DNUIfont* font);
+static DNUIglyph* _DNUI_get_glyph(DNUIfont* font, uint32_t codepoint, bool needBitmap);
+static void _DNUI_drop_missing_glyphs(DNUIfont* font);
+static bool _DNUI_add_to_atlas(DNUIfont* font, DNUIglyph* glyph, const unsigned char* pixels, int pitch);
+static bool _DNUI_evict_glyphs(DNUIfont* font);
+static void _DNUI_repack_atlas(DNUIfont* font, int w, int h);
+static void _DNUI_set_glyph_tex_coords(DNUIfont* font, DNUIglyph* glyph);
+
+static void _DNUI_load_kerning(DNUIfont* font);
+static float _DNUI_get_kerning(DNUIfont* font, uint32_t left, uint32_t right);
+static _DNUIkerningPair* _DNUI_find_kerning_pair(DNUIfont* font, uint32_t left, uint32_t right);
+static void _DNUI_add_kerning_pair(DNUIfont* font, uint32_t left, uint32_t right, float x);
+
+static void _DNUI_load_ascii_metrics(DNUIfont* font);
+static float _DNUI_measure_ascii(DNUIfont* font, const char* text, int len, uint32_t prevCodepoint, float w, bool last, float scale, DNvec2* positions);
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 //for rendering rectangles:
@@ -30,21 +390,55 @@ static GLuint rectProgram;
 static GLuint rectBuffer;
 static GLuint rectArray;
 
+#define DNUI_MAX_SHAPE_POINTS 32 //the maximum number of points the rect shader can take for a single shape, must match MAX_SHAPE_POINTS in rect.frag
+
+typedef enum DNUIshape
+{
+	DNUI_SHAPE_RECT,
+	DNUI_SHAPE_CIRCLE,
+	DNUI_SHAPE_ARC,
+	DNUI_SHAPE_LINE,
+	DNUI_SHAPE_TRIANGLE,
+	DNUI_SHAPE_POLYLINE
+} DNUIshape;
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+//for blurring behind rectangles:
+
+#define DNUI_BLUR_PASSES 4 //the number of times the framebuffer gets downsampled, more passes results in a stronger blur
+
+static GLuint blurProgram;
+static GLuint blurTextures[DNUI_BLUR_PASSES + 1];     //index 0 is the full resolution capture, each following texture is half the size of the previous
+static GLuint blurFramebuffers[DNUI_BLUR_PASSES + 1];
+static unsigned int blurW = 0, blurH = 0;             //the size of the full resolution capture, 0 if the targets have not been created
+static bool blurGenerated = false;                    //whether the blur has already been generated this frame
+
 //--------------------------------------------------------------------------------------------------------------------------------//
 
 static DNvec2 windowSize;
 static DNmat3 projectionMat;
 
+static bool premultipliedAlpha = false;
+
 //--------------------------------------------------------------------------------------------------------------------------------//
 
 bool DNUI_init(unsigned int windowW, unsigned int windowH)
 {
+	glInitialized = true;
+
+	GLint maxTextureSize;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	maxFontAtlasSize = maxTextureSize < DNUI_MAX_FONT_ATLAS_SIZE ? maxTextureSize : DNUI_MAX_FONT_ATLAS_SIZE;
+
 	//load shader programs:
 	//---------------------------------
 	if(!_DNUI_load_shader_program("shaders/vertex.vert", "shaders/rect.frag", &rectProgram))
 		return false;
 	
-	if(!_DNUI_load_shader_program("shaders/vertex.vert", "shaders/text.frag", &textProgram))
+	if(!_DNUI_load_shader_program("shaders/text.vert", "shaders/text.frag", &textProgram))
+		return false;
+
+	if(!_DNUI_load_shader_program("shaders/vertex.vert", "shaders/blur.frag", &blurProgram))
 		return false;
 
 	//create rect vertex buffer:
@@ -78,10 +472,16 @@ bool DNUI_init(unsigned int windowW, unsigned int windowH)
 	glBindVertexArray(textArray);
 	glBindBuffer(GL_ARRAY_BUFFER, textBuffer);
 
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 4, (void*)0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(_DNUItextVertex), (void*)offsetof(_DNUItextVertex, x));
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 4, (void*)(sizeof(GLfloat) * 2));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(_DNUItextVertex), (void*)offsetof(_DNUItextVertex, texX));
 	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(_DNUItextVertex), (void*)offsetof(_DNUItextVertex, color));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(_DNUItextVertex), (void*)offsetof(_DNUItextVertex, outlineColor));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(_DNUItextVertex), (void*)offsetof(_DNUItextVertex, thickness));
+	glEnableVertexAttribArray(4);
 
 	//set projection matrix:
 	//---------------------------------
@@ -89,26 +489,137 @@ bool DNUI_init(unsigned int windowW, unsigned int windowH)
 
 	//initialize freetype:
 	//---------------------------------
-	if(FT_Init_FreeType(&freetypeLib))
-	{
-		printf("DNUI ERROR - FAILED TO INITIALIZE FREETYPE\n");
+	if(!_DNUI_init_freetype())
 		return false;
-	}
 
 	return true;
 }
 
 void DNUI_close()
 {
+	if(layoutCache)
+	{
+		_DNUI_clear_cached_layouts(NULL);
+		for(int i = 0; i < numLayoutCacheEntries; i++)
+		{
+			DNUI_free_text_layout(&layoutCache[i].layout);
+
+			_DNUIlineBreaks* breaks = &layoutCache[i].breaks;
+			free(breaks->offsets);
+			free(breaks->pen);
+			free(breaks->right);
+			free(breaks->wordStarts);
+			free(breaks->wordEnds);
+			free(breaks->wordRights);
+		}
+	}
+
+	free(layoutCache);
+	free(layoutCacheBuckets);
+	layoutCache = NULL;
+	layoutCacheBuckets = NULL;
+	numLayoutCacheEntries = 0;
+	layoutCacheFree = -1;
+
+	if(layoutCacheMutex)
+		_DNUI_mutex_destroy(layoutCacheMutex);
+	layoutCacheMutex = NULL;
+
+	for(int i = 0; i < numCachedFonts; i++)
+		if(fontCache[i]->internal->loading)
+			_DNUI_join_font_load(fontCache[i]);
+
+	if(fontLoadMutex)
+		_DNUI_mutex_destroy(fontLoadMutex);
+	fontLoadMutex = NULL;
+
+	free(finishedFontLoads);
+	finishedFontLoads = NULL;
+	numFinishedFontLoads = 0;
+	maxFinishedFontLoads = 0;
+
+	if(fontFileMutex)
+		_DNUI_mutex_destroy(fontFileMutex);
+	fontFileMutex = NULL;
+
+	free(fontFiles);
+	fontFiles = NULL;
+	numFontFiles = 0;
+	maxFontFiles = 0;
+
+	if(freetypeLib)
+		FT_Done_FreeType(freetypeLib);
+	freetypeLib = NULL;
+
+	//nothing else to free if only font metrics were used:
+	if(!glInitialized)
+		return;
+
+	glInitialized = false;
 	glDeleteProgram(textProgram);
 	glDeleteBuffers(1, &textBuffer);
 	glDeleteVertexArrays(1, &textArray);
 
+	free(textBatch);
+	textBatch = NULL;
+	textBatchSize = 0;
+	textBatchCapacity = 0;
+	textBatching = false;
+
+	for(int i = 0; i < 3; i++)
+	{
+		if(fontArrays[i].texture != 0)
+			glDeleteTextures(1, &fontArrays[i].texture);
+		fontArrays[i] = (_DNUIfontArray){0};
+	}
+
 	glDeleteProgram(rectProgram);
 	glDeleteBuffers(1, &rectBuffer);
 	glDeleteVertexArrays(1, &rectArray);
 
-	FT_Done_FreeType(freetypeLib);
+	glDeleteProgram(blurProgram);
+	if(blurW > 0)
+	{
+		glDeleteTextures(DNUI_BLUR_PASSES + 1, blurTextures);
+		glDeleteFramebuffers(DNUI_BLUR_PASSES + 1, blurFramebuffers);
+	}
+}
+
+static bool _DNUI_init_freetype()
+{
+	//done by DNUI_init(), or by the first font loaded if it wasn't called:
+	if(!freetypeLib && FT_Init_FreeType(&freetypeLib))
+	{
+		printf("DNUI ERROR - FAILED TO INITIALIZE FREETYPE\n");
+		return false;
+	}
+
+	return true;
+}
+
+void DNUI_begin_frame()
+{
+	blurGenerated = false;
+
+	//upload the atlases of fonts that finished loading in the background:
+	//---------------------------------
+	while(fontLoadMutex)
+	{
+		_DNUI_mutex_lock(fontLoadMutex);
+		DNUIfont* font = numFinishedFontLoads > 0 ? finishedFontLoads[0] : NULL;
+		_DNUI_mutex_unlock(fontLoadMutex);
+
+		if(!font)
+			break;
+
+		_DNUI_finish_font_load(font);
+	}
+}
+
+void DNUI_set_premultiplied_alpha(bool enable)
+{
+	_DNUI_flush_text();
+	premultipliedAlpha = enable;
 }
 
 DNvec2 DNUI_get_window_size()
@@ -118,6 +629,7 @@ DNvec2 DNUI_get_window_size()
 
 void DNUI_set_window_size(unsigned int w, unsigned int h)
 {
+	_DNUI_flush_text(); //queued text uses the old projection
 	//set vars:
 	//---------------------------------
 	windowSize.x = w;
@@ -133,346 +645,3451 @@ void DNUI_set_window_size(unsigned int w, unsigned int h)
 //--------------------------------------------------------------------------------------------------------------------------------//
 
 DNUIfont* DNUI_load_font(const char* path, int size)
-{	
-	DNUIfont* res = malloc(sizeof(DNUIfont));
+{
+	return DNUI_load_font_ex(path, 0, size, 0);
+}
 
-	//load freetype face:
-	//---------------------------------
-	FT_Face font;
-	if(FT_New_Face(freetypeLib, path, 0, &font))
+DNUIfont* DNUI_load_font_ex(const char* path, int faceIndex, int size, unsigned int flags)
+{
+	DNUIfont* res = DNUI_load_font_metrics(path, faceIndex, size, flags);
+	if(res && !DNUI_upload_font_atlas(res))
 	{
-		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", path);
+		DNUI_free_font(res);
 		return NULL;
 	}
 
-	FT_Set_Pixel_Sizes(font, 0, size);
+	return res;
+}
 
-	//compute texture dimensions:
+DNUIfont* DNUI_load_font_metrics(const char* path, int faceIndex, int size, unsigned int flags)
+{
+	//reuse the glyphs of an already loaded size:
 	//---------------------------------
-	const int texturePadding = 1;
-
-	int w = 0;
-	int h = 0;
-	for(int i = 32; i < 128; i++)
+	for(int i = 0; i < numCachedFonts; i++)
 	{
-		if(FT_Load_Char(font, i, FT_LOAD_RENDER))
-		{
-			printf("DNUI ERROR - FAILED TO LOAD CHARACTER \"%c\"", i);
-			continue;
-		}
-
-		FT_Render_Glyph(font->glyph, FT_RENDER_MODE_SDF); //TODO: find a way to not render the text twice
+		_DNUIfontInternal* internal = fontCache[i]->internal;
+		if(!internal->baked && internal->faceIndex == faceIndex && internal->flags == flags && strcmp(internal->path, path) == 0)
+			return _DNUI_create_font_handle(fontCache[i], size);
+	}
 
-		res->maxBearing = font->glyph->bitmap_top > res->maxBearing ? font->glyph->bitmap_top : res->maxBearing;
+	DNUIfont* shared = _DNUI_load_shared_font(path, faceIndex, size, flags);
+	if(!shared)
+		return NULL;
 
-		w += font->glyph->bitmap.width + texturePadding;
-		h = font->glyph->bitmap.rows > h ? font->glyph->bitmap.rows : h;
-	}
+	return _DNUI_create_font_handle(shared, size);
+}
 
-	//create texture:
+DNUIfont* DNUI_load_font_async(const char* path, int faceIndex, int size, unsigned int flags)
+{
+	//reuse the glyphs of an already loaded (or loading) size:
 	//---------------------------------
-	GLuint tex;
-	glGenTextures(1, &tex);
-	glBindTexture(GL_TEXTURE_2D, tex);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); //since the bitmaps generated by freetype have an alignment of 1 byte
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	int x = 0;
-	for(int i = 32; i < 128; i++)
+	for(int i = 0; i < numCachedFonts; i++)
 	{
-		if(FT_Load_Char(font, i, FT_LOAD_RENDER))
-		{
-			printf("DNUI ERROR - FAILED TO LOAD CHARACTER \"%c\"", i);
-			continue;
-		}
-
-		FT_Render_Glyph(font->glyph, FT_RENDER_MODE_SDF);
+		_DNUIfontInternal* internal = fontCache[i]->internal;
+		if(!internal->baked && internal->faceIndex == faceIndex && internal->flags == flags && strcmp(internal->path, path) == 0)
+			return _DNUI_create_font_handle(fontCache[i], size);
+	}
 
-		//set data:
-		res->glyphInfo[i].advance = font->glyph->advance.x / 64.0f;
-		res->glyphInfo[i].bmpW = font->glyph->bitmap.width;
-		res->glyphInfo[i].bmpH = font->glyph->bitmap.rows;
-		res->glyphInfo[i].bmpL = font->glyph->bitmap_left;
-		res->glyphInfo[i].bmpT = font->glyph->bitmap_top;
-		res->glyphInfo[i].texOffset = (float)x / w;
+	if(!fontLoadMutex)
+		fontLoadMutex = _DNUI_mutex_create();
+	if(!fontFileMutex)
+		fontFileMutex = _DNUI_mutex_create(); //before the load thread can open any files
 
-		//set texture:
-		glTexSubImage2D(GL_TEXTURE_2D, 0, x, 0, font->glyph->bitmap.width, font->glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE, font->glyph->bitmap.buffer);
+	//create the font straight away, so the handle can be returned before anything is loaded:
+	//---------------------------------
+	DNUIfont* shared = _DNUI_create_font(size, 96);
+	shared->internal->flags = flags;
+	shared->internal->path = malloc(strlen(path) + 1);
+	strcpy(shared->internal->path, path);
+	shared->internal->faceIndex = faceIndex;
+	shared->internal->loading = true;
 
-		//advance:
-		x += font->glyph->bitmap.width + texturePadding;
-	}
+	DNUIfont* res = _DNUI_create_font_handle(shared, size);
 
-	res->textureAtlas = tex;
-	res->atlasW = w;
-	res->atlasH = h;
+	//fonts whose thread fails to start are loaded on the calling thread instead, still becoming ready in DNUI_begin_frame():
+	shared->internal->loadThread = _DNUI_thread_create(_DNUI_font_load_thread, shared);
+	if(!shared->internal->loadThread)
+		_DNUI_font_load_thread(shared);
 
 	return res;
 }
 
-void DNUI_free_font(DNUIfont* font)
+DNUIfont* DNUI_load_baked_font(const char* path)
 {
-	glDeleteTextures(1, &font->textureAtlas);
-	free(font);
+	for(int i = 0; i < numCachedFonts; i++)
+	{
+		_DNUIfontInternal* internal = fontCache[i]->internal;
+		if(internal->baked && strcmp(internal->path, path) == 0)
+			return _DNUI_create_font_handle(fontCache[i], internal->size);
+	}
+
+	DNUIfont* shared = _DNUI_load_shared_baked_font(path);
+	if(!shared)
+		return NULL;
+
+	return _DNUI_create_font_handle(shared, shared->internal->size);
 }
 
-DNvec2 DNUI_line_render_size(const char* text, DNUIfont* font, float scale, DNvec2* charPositions)
+bool DNUI_upload_font_atlas(DNUIfont* font)
 {
-	float w = 0.0;
+	DNUIfont* shared = font->shared;
 
-	int i = 0;
-	for(char* c = (char*)text; *c != '\0'; c++)
-	{
-		if(charPositions)
-		{
-			charPositions[i].x = w * scale;
-			charPositions[i].y = (w + font->glyphInfo[*c].advance) * scale;
-		}
+	//asynchronously loaded fonts are waited for instead:
+	if(shared->internal->loading)
+		return _DNUI_finish_font_load(shared);
 
-		if(*(c + 1) == '\0')
-			w += font->glyphInfo[*c].bmpL + font->glyphInfo[*c].bmpW;
-		else
-			w += font->glyphInfo[*c].advance;
+	_DNUI_mutex_lock(shared->internal->mutex);
+	bool result = shared->textureAtlas != 0 || _DNUI_create_atlas(shared);
+	_DNUI_mutex_unlock(shared->internal->mutex);
 
-		i++;
-	}
+	_DNUI_update_font_handles(shared);
+	return result;
+}
 
-	return (DNvec2){w * scale, font->atlasH * scale};
+bool DNUI_font_ready(const DNUIfont* font)
+{
+	return !font->internal->loading;
 }
 
-DNvec2 DNUI_string_render_size(const char* text, DNUIfont* font, float scale, float maxW)
+static DNUIfont* _DNUI_load_shared_font(const char* path, int faceIndex, int size, unsigned int flags)
 {
-	DNvec2 res;
-	if(maxW <= 0.0f)
-		return DNUI_line_render_size(text, font, scale, NULL);
-	else
-		res.x = maxW;
+	if(!_DNUI_init_freetype())
+		return NULL;
 
-	int len = strlen(text);
-	int numLines = 0;
-	int startPos = 0;
-	int lastSpace = -1;
-	float curWidth = 0.0;
+	DNUIfont* res = _DNUI_create_font(size, 96);
+	res->internal->flags = flags;
+	res->internal->path = malloc(strlen(path) + 1);
+	strcpy(res->internal->path, path);
+	res->internal->faceIndex = faceIndex;
 
-	int i;
-	for(i = 0; i < len; i++)
+	if(!_DNUI_load_font_faces(res, freetypeLib))
 	{
-		char test = text[i];
-
-		if(text[i] == ' ')
-		{
-			lastSpace = i;
-			curWidth += font->glyphInfo[text[i]].advance * scale;
-		}
-		else if(curWidth + (font->glyphInfo[text[i]].bmpL + font->glyphInfo[text[i]].bmpW) * scale > maxW)
-		{
-			int endPos = lastSpace <= startPos ? i : lastSpace + 1;
-			numLines++;
-			startPos = endPos;
-			i = startPos;
-			curWidth = 0.0;
-		}
-		else
-			curWidth += font->glyphInfo[text[i]].advance * scale;
+		_DNUI_free_shared_font(res);
+		return NULL;
 	}
 
-	if(i > startPos)
-		numLines++;
-
-	res.y = numLines * font->atlasH * scale;
 	return res;
 }
 
-//draws a single line of text
-void _DNUI_draw_string_line(const char* text, DNUIfont* font, DNvec2 pos, float scale, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+static bool _DNUI_load_font_faces(DNUIfont* font, FT_Library lib)
 {
-	//create vertex array:
+	_DNUIfontInternal* internal = font->internal;
+
+	//open font file, kept open to render glyphs from:
 	//---------------------------------
-	struct Vertex
+	_DNUIfontFile* file = _DNUI_open_font_file(internal->path);
+	if(!file)
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", internal->path);
+		return false;
+	}
+
+	FT_Face face;
+	if(FT_New_Memory_Face(lib, file->data, (FT_Long)file->size, internal->faceIndex, &face))
 	{
-		GLfloat x;
-		GLfloat y;
-		GLfloat texX;
-		GLfloat texY;
-	}* vertices;
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", internal->path);
+		_DNUI_close_font_file(file);
+		return false;
+	}
 
-	int len = strlen(text);
-	int numVertices = 6 * len;
-	vertices = malloc(4 * sizeof(GLfloat) * numVertices);
+	FT_Set_Pixel_Sizes(face, 0, internal->size);
 
-	//generate vertex data:
+	internal->faces[0] = face;
+	internal->faceFiles[0] = file;
+	internal->numFaces = 1;
+
+	//measure printable ascii up front, their bitmaps are rendered when the atlas is created:
 	//---------------------------------
-	int i = 0;
-	for(char* c = (char*)text; *c != '\0'; c++)
+	uint32_t codepoints[96];
+	_DNUIglyphBitmap metrics[96] = {0};
+	for(int i = 0; i < 96; i++)
 	{
-		float texOffset = font->glyphInfo[*c].texOffset;
-		float bmpW = font->glyphInfo[*c].bmpW / font->atlasW;
-		float bmpH = font->glyphInfo[*c].bmpH / font->atlasH;
+		codepoints[i] = 32 + i;
+		DNUIglyph* glyph = _DNUI_get_glyph(font, codepoints[i], false);
 
-		float x =  pos.x + font->glyphInfo[*c].bmpL * scale;
-		float y = -pos.y - (font->glyphInfo[*c].bmpT - font->maxBearing) * scale;
-		float w = font->glyphInfo[*c].bmpW * scale;
-		float h = font->glyphInfo[*c].bmpH * scale;
+		//glyphs the font lacks don't count towards the line spacing:
+		metrics[i].loaded = FT_Get_Char_Index(face, codepoints[i]) != 0;
+		metrics[i].h = (unsigned int)glyph->bmpH;
+		metrics[i].t = (int)glyph->bmpT;
+	}
 
-		pos.x += font->glyphInfo[*c].advance * scale;
+	_DNUI_get_line_metrics(metrics, codepoints, 96, &font->maxBearing, &font->lineHeight);
+	_DNUI_load_kerning(font);
 
-		//don't render spaces
-		if(w <= 0.0 || h <= 0.0)
-			continue;
+	return true;
+}
 
-		vertices[i++] = (struct Vertex){x	 , -y	 , texOffset		, 0.0 };
-		vertices[i++] = (struct Vertex){x + w, -y	 , texOffset + bmpW, 0.0 };
-		vertices[i++] = (struct Vertex){x	 , -y - h, texOffset		, bmpH};
-		vertices[i++] = (struct Vertex){x + w, -y	 , texOffset + bmpW, 0.0 };
-		vertices[i++] = (struct Vertex){x	 , -y - h, texOffset		, bmpH};
-		vertices[i++] = (struct Vertex){x + w, -y - h, texOffset + bmpW, bmpH};
-	}
+static void _DNUI_font_load_thread(void* data)
+{
+	DNUIfont* font = data;
+	_DNUIfontInternal* internal = font->internal;
 
-	//send to GPU:
+	//libraries aren't thread safe, so the font's faces get their own:
 	//---------------------------------
-	glBindBuffer(GL_ARRAY_BUFFER, textBuffer);
-	glBufferData(GL_ARRAY_BUFFER, 4 * sizeof(GLfloat) * i, vertices, GL_DYNAMIC_DRAW);
-
-	glUseProgram(textProgram);
-	glUniform4fv(glGetUniformLocation(textProgram, "color"), 1, (GLfloat*)&color);
-	glUniform4fv(glGetUniformLocation(textProgram, "outlineColor"), 1, (GLfloat*)&outlineColor);
-	glUniformMatrix3fv(glGetUniformLocation(textProgram, "modelProjection"), 1, GL_FALSE, (GLfloat*)&projectionMat);
-	glUniform1i(glGetUniformLocation(textProgram, "textureAtlas"), 0);
-	glUniform1f(glGetUniformLocation(textProgram, "scale"), scale);
-	glUniform1f(glGetUniformLocation(textProgram, "thickness"), 1.0 - thickness);
-	glUniform1f(glGetUniformLocation(textProgram, "softness"), softness);
-	glUniform1f(glGetUniformLocation(textProgram, "outlineThickness"), 1.0 - outlineThickness);
-	glUniform1f(glGetUniformLocation(textProgram, "outlineSoftness"), outlineSoftness);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, font->textureAtlas);
+	if(FT_Init_FreeType(&internal->lib))
+	{
+		printf("DNUI ERROR - FAILED TO INITIALIZE FREETYPE\n");
+		internal->lib = NULL;
+		internal->loadFailed = true;
+	}
+	else
+		internal->loadFailed = !_DNUI_load_font_faces(font, internal->lib) || !_DNUI_render_atlas(font, internal->lib);
 
-	glBindVertexArray(textArray);
-	glDrawArrays(GL_TRIANGLES, 0, i);
+	//queue the atlas to be uploaded on the openGL thread:
+	//---------------------------------
+	_DNUI_mutex_lock(fontLoadMutex);
+	if(numFinishedFontLoads >= maxFinishedFontLoads)
+	{
+		maxFinishedFontLoads = maxFinishedFontLoads > 0 ? maxFinishedFontLoads * 2 : 8;
+		finishedFontLoads = realloc(finishedFontLoads, maxFinishedFontLoads * sizeof(DNUIfont*));
+	}
 
-	free(vertices);
+	finishedFontLoads[numFinishedFontLoads++] = font;
+	_DNUI_mutex_unlock(fontLoadMutex);
 }
 
-void DNUI_draw_string(const char* text, DNUIfont* font, DNvec2 pos, float scale, float maxW, int align, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+static void _DNUI_join_font_load(DNUIfont* font)
 {
-	DNvec2 size = DNUI_string_render_size(text, font, scale, maxW);
-	pos.x -= size.x * 0.5f;
-	pos.y += size.y * 0.5f;
-
-	if(maxW <= 0.0)
-	{
-		_DNUI_draw_string_line(text, font, pos, scale, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+	//DNUI_close() already joined every load thread:
+	if(!fontLoadMutex)
 		return;
-	}
 
-	int len = strlen(text);
-	int numLines = 0;
-	int startPos = 0;
-	int lastSpace = -1;
-	float curWidth = 0.0;
+	if(font->internal->loadThread)
+		_DNUI_thread_join(font->internal->loadThread);
+	font->internal->loadThread = NULL;
 
-	int i;
-	for(i = 0; i < len; i++)
+	//queueing the font is the thread's last step, so it's always queued (or already removed) once joined:
+	_DNUI_mutex_lock(fontLoadMutex);
+	for(int i = 0; i < numFinishedFontLoads; i++)
 	{
-		char test = text[i];
-
-		if(isspace(text[i]))
+		if(finishedFontLoads[i] == font)
 		{
-			lastSpace = i;
-			curWidth += font->glyphInfo[text[i]].advance * scale;
+			memmove(&finishedFontLoads[i], &finishedFontLoads[i + 1], (numFinishedFontLoads - i - 1) * sizeof(DNUIfont*));
+			numFinishedFontLoads--;
+			break;
 		}
-		else if(curWidth + (font->glyphInfo[text[i]].bmpL + font->glyphInfo[text[i]].bmpW) * scale > maxW)
-		{
-			char* line;
+	}
+	_DNUI_mutex_unlock(fontLoadMutex);
+}
+
+static bool _DNUI_finish_font_load(DNUIfont* font)
+{
+	_DNUIfontInternal* internal = font->internal;
+	_DNUI_join_font_load(font);
+	if(internal->loadFailed)
+		return false;
 
-			int endPos = lastSpace <= startPos ? i : lastSpace + 1;
-			line = malloc(endPos - startPos + 1);
-			memcpy(line, &text[startPos], endPos - startPos);
-			line[endPos - startPos] = '\0';
+	//other threads may be measuring the font's placeholder size:
+	_DNUI_mutex_lock(internal->mutex);
+	bool result = _DNUI_create_atlas(font);
+	internal->loading = false;
+	_DNUI_mutex_unlock(internal->mutex);
 
-			float x = pos.x;
-			if(align == 1)
-				x += size.x - DNUI_line_render_size(line, font, scale, NULL).x;
-			else if(align == 2)
-				x += (size.x - DNUI_line_render_size(line, font, scale, NULL).x) * 0.5f;
+	_DNUI_update_font_handles(font);
+	return result;
+}
 
-			_DNUI_draw_string_line(line, font, (DNvec2){x, pos.y - font->atlasH * scale * numLines}, scale, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+static DNUIfont* _DNUI_load_shared_baked_font(const char* path)
+{
+	const unsigned char* data;
+	size_t dataSize;
+	_DNUIfileMapping* file = _DNUI_map_file(path, (const void**)&data, &dataSize);
+	if(!file)
+	{
+		printf("DNUI ERROR - FAILED TO LOAD BAKED FONT \"%s\"\n", path);
+		return NULL;
+	}
 
-			free(line);
+	//validate:
+	//---------------------------------
+	const _DNUIbakedFontHeader* header = (const _DNUIbakedFontHeader*)data;
+	size_t glyphsPos = sizeof(_DNUIbakedFontHeader);
+	size_t kerningPos = 0;
+	size_t atlasPos = 0;
+	size_t end = 0;
 
-			numLines++;
-			startPos = endPos;
-			i = startPos;
-			curWidth = 0.0;
-		}
+	bool valid = dataSize >= sizeof(_DNUIbakedFontHeader) && memcmp(header->magic, DNUI_BAKED_FONT_MAGIC, 4) == 0;
+	if(valid)
+	{
+		kerningPos = glyphsPos + (size_t)header->numGlyphs * sizeof(_DNUIbakedGlyph);
+		atlasPos = kerningPos + (size_t)header->numKerningPairs * sizeof(_DNUIbakedKerningPair);
+		if(_DNUI_wants_compressed_atlas(header->flags))
+			end = atlasPos + _DNUI_get_compressed_atlas_size(header->atlasW, header->atlasH);
 		else
-			curWidth += font->glyphInfo[text[i]].advance * scale;
+			end = atlasPos + (size_t)header->atlasW * header->atlasH * _DNUI_get_atlas_channels(header->flags);
 	}
 
-	if(i > startPos)
+	if(!valid || header->version != DNUI_BAKED_FONT_VERSION || dataSize < end)
 	{
-		char* line;
-
-		line = malloc(i - startPos + 1);
-		memcpy(line, &text[startPos], i - startPos);
-		line[i - startPos] = '\0';
+		printf("DNUI ERROR - \"%s\" IS NOT A VALID BAKED FONT, OR WAS BAKED WITH A DIFFERENT VERSION\n", path);
+		_DNUI_unmap_file(file);
+		return NULL;
+	}
 
-		float x = pos.x;
-		if(align == 1)
-			x += size.x - DNUI_line_render_size(line, font, scale, NULL).x;
-		else if(align == 2)
-			x += (size.x - DNUI_line_render_size(line, font, scale, NULL).x) * 0.5f;
+	//create font, glyphs missing from the file can't be rendered since there is no face:
+	//---------------------------------
+	DNUIfont* res = _DNUI_create_font(header->size, header->numGlyphs);
+	res->internal->baked = true;
+	res->internal->flags = header->flags;
+	res->internal->path = malloc(strlen(path) + 1);
+	strcpy(res->internal->path, path);
+	res->atlasW = header->atlasW;
+	res->atlasH = header->atlasH;
+	res->maxBearing = header->maxBearing;
+	res->lineHeight = header->lineHeight;
 
-		_DNUI_draw_string_line(line, font, (DNvec2){x, pos.y - font->atlasH * scale * numLines}, scale, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+	const _DNUIbakedGlyph* bakedGlyphs = (const _DNUIbakedGlyph*)&data[glyphsPos];
+	for(uint32_t i = 0; i < header->numGlyphs; i++)
+	{
+		DNUIglyph* glyph = _DNUI_find_glyph(res, bakedGlyphs[i].codepoint);
+		if(!glyph->loaded)
+			res->numGlyphs++;
 
-		free(line);
+		glyph->codepoint = bakedGlyphs[i].codepoint;
+		glyph->loaded = true;
+		glyph->resident = true;
+		glyph->advance = bakedGlyphs[i].advance;
+		glyph->bmpW = bakedGlyphs[i].bmpW;
+		glyph->bmpH = bakedGlyphs[i].bmpH;
+		glyph->bmpL = bakedGlyphs[i].bmpL;
+		glyph->bmpT = bakedGlyphs[i].bmpT;
+		glyph->atlasX = bakedGlyphs[i].atlasX;
+		glyph->atlasY = bakedGlyphs[i].atlasY;
+		_DNUI_set_glyph_tex_coords(res, glyph);
 	}
-}
 
-void DNUI_draw_string_simple(const char* text, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color)
+	const _DNUIbakedKerningPair* bakedPairs = (const _DNUIbakedKerningPair*)&data[kerningPos];
+	if(header->numKerningPairs > 0)
+		res->internal->asciiKerning = calloc(DNUI_KERNING_TABLE_SIZE * DNUI_KERNING_TABLE_SIZE, sizeof(float));
+
+	for(uint32_t i = 0; i < header->numKerningPairs; i++)
+		_DNUI_add_kerning_pair(res, bakedPairs[i].left, bakedPairs[i].right, bakedPairs[i].x);
+
+	//upload straight from the mapped file, compressed atlases are decompressed first if rgtc isn't supported:
+	//---------------------------------
+	res->textureAtlas = _DNUI_create_atlas_texture(res);
+
+	if(!_DNUI_wants_compressed_atlas(header->flags))
+		_DNUI_upload_atlas(res, &data[atlasPos]);
+	else if(_DNUI_use_compressed_atlas(header->flags))
+		_DNUI_upload_atlas_data(res, &data[atlasPos]);
+	else
+	{
+		unsigned char* atlas = malloc((size_t)header->atlasW * header->atlasH);
+		_DNUI_decompress_atlas(&data[atlasPos], header->atlasW, header->atlasH, atlas);
+		_DNUI_upload_atlas(res, atlas);
+		free(atlas);
+	}
+
+	_DNUI_unmap_file(file);
+	return res;
+}
+
+bool DNUI_bake_font(const char* path, int size, unsigned int flags, const uint32_t* codepoints, int numCodepoints, const char* outPath)
+{
+	_DNUIfontFile* file = _DNUI_open_font_file(path);
+	if(!file)
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", path);
+		return false;
+	}
+
+	//render and pack glyphs:
+	//---------------------------------
+	_DNUIglyphBitmap* glyphs = calloc(numCodepoints, sizeof(_DNUIglyphBitmap));
+	_DNUIfontWorker workers[DNUI_MAX_FONT_WORKERS];
+	unsigned int numWorkers;
+	if(!_DNUI_render_glyphs(freetypeLib, file->data, file->size, 0, size, flags, codepoints, numCodepoints, glyphs, workers, &numWorkers))
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", path);
+		free(glyphs);
+		_DNUI_close_font_file(file);
+		return false;
+	}
+
+	_DNUIskyline skyline;
+	int w, h;
+	int channels = _DNUI_get_atlas_channels(flags);
+	unsigned char* atlas = _DNUI_pack_glyphs(glyphs, numCodepoints, workers, channels, DNUI_MAX_FONT_ATLAS_SIZE, &w, &h, &skyline);
+
+	for(unsigned int i = 0; i < numWorkers; i++)
+		free(workers[i].arena);
+
+	if(!atlas)
+	{
+		printf("DNUI ERROR - FONT \"%s\" AT SIZE %d DOES NOT FIT IN A %dx%d TEXTURE\n", path, size, DNUI_MAX_FONT_ATLAS_SIZE, DNUI_MAX_FONT_ATLAS_SIZE);
+		free(glyphs);
+		_DNUI_close_font_file(file);
+		return false;
+	}
+
+	_DNUI_skyline_free(&skyline);
+
+	//fill out file sections:
+	//---------------------------------
+	_DNUIbakedFontHeader header = {0};
+	memcpy(header.magic, DNUI_BAKED_FONT_MAGIC, 4);
+	header.version = DNUI_BAKED_FONT_VERSION;
+	header.size = size;
+	header.flags = flags;
+	header.atlasW = w;
+	header.atlasH = h;
+	_DNUI_get_line_metrics(glyphs, codepoints, numCodepoints, &header.maxBearing, &header.lineHeight);
+
+	_DNUIbakedGlyph* bakedGlyphs = malloc(numCodepoints * sizeof(_DNUIbakedGlyph));
+	for(int i = 0; i < numCodepoints; i++)
+	{
+		if(!glyphs[i].loaded)
+			continue;
+
+		bakedGlyphs[header.numGlyphs++] = (_DNUIbakedGlyph){
+			codepoints[i], glyphs[i].advance, (float)glyphs[i].w, (float)glyphs[i].h, (float)glyphs[i].l, (float)glyphs[i].t, glyphs[i].atlasX, glyphs[i].atlasY
+		};
+	}
+
+	_DNUIbakedKerningPair* kerningPairs = NULL;
+	_DNUI_get_kerning_pairs(file->data, file->size, size, bakedGlyphs, header.numGlyphs, &kerningPairs, &header.numKerningPairs);
+
+	size_t atlasSize = (size_t)w * h * channels;
+	if(_DNUI_wants_compressed_atlas(flags))
+	{
+		atlasSize = _DNUI_get_compressed_atlas_size(w, h);
+		unsigned char* blocks = malloc(atlasSize);
+		_DNUI_compress_atlas(atlas, w, h, 0, 0, w, h, blocks);
+
+		free(atlas);
+		atlas = blocks;
+	}
+
+	//write:
+	//---------------------------------
+	bool result = false;
+	FILE* outFile = fopen(outPath, "wb");
+	if(outFile)
+	{
+		result = fwrite(&header, sizeof(_DNUIbakedFontHeader), 1, outFile) == 1 &&
+		         fwrite(bakedGlyphs, sizeof(_DNUIbakedGlyph), header.numGlyphs, outFile) == header.numGlyphs &&
+		         fwrite(kerningPairs, sizeof(_DNUIbakedKerningPair), header.numKerningPairs, outFile) == header.numKerningPairs &&
+		         fwrite(atlas, 1, atlasSize, outFile) == atlasSize;
+
+		fclose(outFile);
+	}
+
+	if(!result)
+		printf("DNUI ERROR - COULD NOT WRITE TO FILE %s\n", outPath);
+
+	free(kerningPairs);
+	free(bakedGlyphs);
+	free(atlas);
+	free(glyphs);
+	_DNUI_close_font_file(file);
+
+	return result;
+}
+
+bool DNUI_add_fallback_font(DNUIfont* font, const char* path)
+{
+	_DNUIfontInternal* internal = font->internal;
+	if(internal->loading && !_DNUI_finish_font_load(font->shared))
+		return false;
+
+	if(internal->baked)
+	{
+		printf("DNUI ERROR - FALLBACK FONTS CAN'T BE ADDED TO BAKED FONTS\n");
+		return false;
+	}
+
+	if(internal->numFaces > DNUI_MAX_FALLBACK_FONTS)
+	{
+		printf("DNUI ERROR - A FONT CAN HAVE AT MOST %d FALLBACK FONTS\n", DNUI_MAX_FALLBACK_FONTS);
+		return false;
+	}
+
+	FT_Face face;
+	_DNUIfontFile* file = _DNUI_open_font_file(path);
+	if(!file)
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", path);
+		return false;
+	}
+
+	//kept in the same library as the font's other faces:
+	if(FT_New_Memory_Face(internal->lib ? internal->lib : freetypeLib, file->data, (FT_Long)file->size, 0, &face))
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", path);
+		_DNUI_close_font_file(file);
+		return false;
+	}
+
+	FT_Set_Pixel_Sizes(face, 0, internal->size);
+
+	//glyphs that fell back to the primary face's missing glyph may be in the new face, so they're dropped and loaded again the next time they're used:
+	//---------------------------------
+	DNUIfont* shared = font->shared;
+	_DNUI_mutex_lock(internal->mutex);
+	_DNUI_drop_missing_glyphs(shared);
+	internal->faces[internal->numFaces] = face;
+	internal->faceFiles[internal->numFaces] = file;
+	internal->numFaces++;
+
+	//strings measured or laid out with the missing glyphs' metrics are stale too:
+	_DNUI_mutex_lock(layoutCacheMutex);
+	if(layoutCache)
+		_DNUI_clear_cached_layouts(shared);
+	_DNUI_mutex_unlock(layoutCacheMutex);
+
+	_DNUI_mutex_unlock(internal->mutex);
+
+	return true;
+}
+
+void DNUI_set_font_load_threads(unsigned int count)
+{
+	fontLoadThreads = count;
+}
+
+void DNUI_free_font(DNUIfont* font)
+{
+	DNUIfont* shared = font->shared;
+	_DNUIfontInternal* internal = shared->internal;
+	for(int i = 0; i < internal->numHandles; i++)
+	{
+		if(internal->handles[i] == font)
+		{
+			internal->handles[i] = internal->handles[--internal->numHandles];
+			break;
+		}
+	}
+
+	free(font);
+	if(internal->numHandles == 0)
+		_DNUI_free_shared_font(shared);
+}
+
+static void _DNUI_free_shared_font(DNUIfont* shared)
+{
+	//the load thread must be done with the font first:
+	if(shared->internal->loading)
+		_DNUI_join_font_load(shared);
+
+	_DNUI_flush_text(); //queued text may use the font's atlas
+
+	//cached strings would match a font allocated at the same address later:
+	_DNUI_mutex_lock(layoutCacheMutex);
+	if(layoutCache)
+		_DNUI_clear_cached_layouts(shared);
+	_DNUI_mutex_unlock(layoutCacheMutex);
+
+	//last handle, remove from cache and free the glyphs:
+	//---------------------------------
+	for(int i = 0; i < numCachedFonts; i++)
+	{
+		if(fontCache[i] == shared)
+		{
+			fontCache[i] = fontCache[--numCachedFonts];
+			break;
+		}
+	}
+
+	for(int i = 0; i < shared->internal->numFaces; i++)
+	{
+		FT_Done_Face(shared->internal->faces[i]);
+		_DNUI_close_font_file(shared->internal->faceFiles[i]);
+	}
+
+	if(shared->internal->lib)
+		FT_Done_FreeType(shared->internal->lib);
+
+	_DNUI_skyline_free(&shared->internal->skyline);
+	free(shared->internal->atlasImage);
+	free(shared->internal->asciiKerning);
+	free(shared->internal->kerningPairs);
+	free(shared->internal->path);
+	free(shared->internal->handles);
+	free(shared->glyphs);
+
+	if(shared->textureAtlas != 0 && !(shared->internal->flags & DNUI_FONT_TEXTURE_ARRAY)) //the font's layer is reused by the next font added to the array
+		glDeleteTextures(1, &shared->textureAtlas);
+	_DNUI_mutex_destroy(shared->internal->mutex);
+	free(shared->internal);
+	free(shared);
+}
+
+int DNUI_utf8_decode(const char* text, uint32_t* codepoint)
+{
+	return DNUI_utf8_decode_n(text, SIZE_MAX, codepoint);
+}
+
+int DNUI_utf8_decode_n(const char* text, size_t len, uint32_t* codepoint)
+{
+	const unsigned char* str = (const unsigned char*)text;
+	if(str[0] < 0x80)
+	{
+		*codepoint = str[0];
+		return 1;
+	}
+
+	int seqLen;
+	uint32_t cp;
+	if((str[0] & 0xE0) == 0xC0)
+	{
+		seqLen = 2;
+		cp = str[0] & 0x1F;
+	}
+	else if((str[0] & 0xF0) == 0xE0)
+	{
+		seqLen = 3;
+		cp = str[0] & 0x0F;
+	}
+	else if((str[0] & 0xF8) == 0xF0)
+	{
+		seqLen = 4;
+		cp = str[0] & 0x07;
+	}
+	else
+	{
+		*codepoint = DNUI_REPLACEMENT_CHARACTER;
+		return 1;
+	}
+
+	//stops at the end of the text, or the null terminator since it isn't a continuation byte:
+	for(int i = 1; i < seqLen; i++)
+	{
+		if((size_t)i >= len || (str[i] & 0xC0) != 0x80)
+		{
+			*codepoint = DNUI_REPLACEMENT_CHARACTER;
+			return i;
+		}
+
+		cp = (cp << 6) | (str[i] & 0x3F);
+	}
+
+	//reject overlong encodings, surrogates, and values past the end of unicode:
+	const uint32_t minCodepoint[5] = {0, 0, 0x80, 0x800, 0x10000};
+	if(cp < minCodepoint[seqLen] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF)
+		cp = DNUI_REPLACEMENT_CHARACTER;
+
+	*codepoint = cp;
+	return seqLen;
+}
+
+int DNUI_utf8_encode(uint32_t codepoint, char* out)
+{
+	if(codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+		codepoint = DNUI_REPLACEMENT_CHARACTER;
+
+	if(codepoint < 0x80)
+	{
+		out[0] = (char)codepoint;
+		return 1;
+	}
+	else if(codepoint < 0x800)
+	{
+		out[0] = (char)(0xC0 | (codepoint >> 6));
+		out[1] = (char)(0x80 | (codepoint & 0x3F));
+		return 2;
+	}
+	else if(codepoint < 0x10000)
+	{
+		out[0] = (char)(0xE0 | (codepoint >> 12));
+		out[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (codepoint & 0x3F));
+		return 3;
+	}
+	else
+	{
+		out[0] = (char)(0xF0 | (codepoint >> 18));
+		out[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		out[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out[3] = (char)(0x80 | (codepoint & 0x3F));
+		return 4;
+	}
+}
+
+int DNUI_utf8_length(const char* text)
+{
+	return DNUI_utf8_length_n(text, strlen(text));
+}
+
+int DNUI_utf8_length_n(const char* text, size_t len)
+{
+	int numCodepoints = 0;
+	size_t i = 0;
+	uint32_t codepoint;
+	while(i < len)
+	{
+		i += DNUI_utf8_decode_n(&text[i], len - i, &codepoint);
+		numCodepoints++;
+	}
+
+	return numCodepoints;
+}
+
+DNvec2 DNUI_line_render_size(const char* text, DNUIfont* font, float scale, DNvec2* charPositions)
+{
+	return DNUI_line_render_size_n(text, strlen(text), font, scale, charPositions);
+}
+
+DNvec2 DNUI_line_render_size_n(const char* text, size_t len, DNUIfont* font, float scale, DNvec2* charPositions)
+{
+	//every size loaded from a file draws the same glyphs, just scaled:
+	scale *= font->sizeScale;
+	font = font->shared;
+	_DNUI_mutex_lock(font->internal->mutex);
+
+	//fonts still loading have no glyphs to measure, so they're as tall as their size until ready:
+	if(font->internal->loading)
+	{
+		if(charPositions)
+			memset(charPositions, 0, DNUI_utf8_length_n(text, len) * sizeof(DNvec2));
+
+		_DNUI_mutex_unlock(font->internal->mutex);
+		return (DNvec2){0.0f, font->internal->size * scale};
+	}
+
+	float w = 0.0;
+
+	int i = 0;
+	uint32_t prevCodepoint = 0;
+	const char* c = text;
+	const char* end = text + len;
+	while(c < end)
+	{
+		//runs of ascii are measured together, skipping the glyph table:
+		int run = 0;
+		while(c + run < end && (unsigned char)c[run] < DNUI_KERNING_TABLE_SIZE)
+			run++;
+
+		if(run > 0)
+		{
+			w = _DNUI_measure_ascii(font, c, run, prevCodepoint, w, c + run == end, scale, charPositions ? &charPositions[i] : NULL);
+			prevCodepoint = (unsigned char)c[run - 1];
+			c += run;
+			i += run;
+			continue;
+		}
+
+		uint32_t codepoint;
+		c += DNUI_utf8_decode_n(c, end - c, &codepoint);
+		DNUIglyph* glyph = _DNUI_get_glyph(font, codepoint, false);
+
+		w += _DNUI_get_kerning(font, prevCodepoint, codepoint);
+		prevCodepoint = codepoint;
+
+		if(charPositions)
+		{
+			charPositions[i].x = w * scale;
+			charPositions[i].y = (w + glyph->advance) * scale;
+		}
+
+		if(c == end)
+			w += glyph->bmpL + glyph->bmpW;
+		else
+			w += glyph->advance;
+
+		i++;
+	}
+
+	_DNUI_mutex_unlock(font->internal->mutex);
+	return (DNvec2){w * scale, font->lineHeight * scale};
+}
+
+DNvec2 DNUI_string_render_size(const char* text, DNUIfont* font, float scale, float maxW)
+{
+	return DNUI_string_render_size_n(text, strlen(text), font, scale, maxW);
+}
+
+DNvec2 DNUI_string_render_size_n(const char* text, size_t len, DNUIfont* font, float scale, float maxW)
+{
+	scale *= font->sizeScale;
+	font = font->shared;
+
+	_DNUI_mutex_lock(layoutCacheMutex);
+	_DNUIlayoutCacheEntry* entry = _DNUI_get_cached_layout(text, (int)len, font, false, scale, maxW, false);
+	if(entry)
+	{
+		DNvec2 res = entry->size;
+		_DNUI_mutex_unlock(layoutCacheMutex);
+		return res;
+	}
+
+	_DNUI_mutex_unlock(layoutCacheMutex);
+
+	//the cache must be locked after the font, so it's unlocked while waiting for the font:
+	//---------------------------------
+	_DNUI_mutex_lock(font->internal->mutex);
+	DNvec2 res = _DNUI_layout_text(text, (int)len, font, scale, maxW, 0, NULL);
+	bool loading = font->internal->loading; //placeholder sizes aren't cached
+	_DNUI_mutex_unlock(font->internal->mutex);
+
+	if(!loading)
+	{
+		_DNUI_mutex_lock(layoutCacheMutex);
+		entry = _DNUI_get_cached_layout(text, (int)len, font, false, scale, maxW, true);
+		entry->size = res;
+		_DNUI_mutex_unlock(layoutCacheMutex);
+	}
+
+	return res;
+}
+
+void DNUI_layout_string(const char* text, DNUIfont* font, float scale, float maxW, int align, DNUItextLayout* layout)
+{
+	DNUI_layout_string_n(text, strlen(text), font, scale, maxW, align, layout);
+}
+
+void DNUI_layout_string_n(const char* text, size_t len, DNUIfont* font, float scale, float maxW, int align, DNUItextLayout* layout)
+{
+	layout->font = font;
+	layout->scale = scale;
+
+	DNUIfont* shared = font->shared;
+	_DNUI_mutex_lock(shared->internal->mutex);
+	_DNUI_layout_text(text, (int)len, shared, scale * font->sizeScale, maxW, align, layout);
+	_DNUI_mutex_unlock(shared->internal->mutex);
+}
+
+void DNUI_free_text_layout(DNUItextLayout* layout)
+{
+	free(layout->codepoints);
+	free(layout->positions);
+	free(layout->textOffsets);
+	free(layout->lines);
+	*layout = (DNUItextLayout){0};
+}
+
+int DNUI_text_layout_hit_test(const DNUItextLayout* layout, DNvec2 pos, DNvec2 point)
+{
+	if(layout->numLines == 0)
+		return 0;
+
+	//find the line, then the nearest gap between glyphs on it:
+	//---------------------------------
+	int lineIndex = (int)floorf((pos.y + layout->size.y * 0.5f - point.y) / layout->lineHeight);
+	lineIndex = lineIndex < 0 ? 0 : lineIndex >= layout->numLines ? layout->numLines - 1 : lineIndex;
+
+	const DNUItextLine* line = &layout->lines[lineIndex];
+	float x = point.x - (pos.x - layout->size.x * 0.5f + line->x);
+	for(int i = line->firstGlyph; i < line->firstGlyph + line->numGlyphs; i++)
+		if(x < (layout->positions[i].x + layout->positions[i].y) * 0.5f)
+			return layout->textOffsets[i];
+
+	return line->textEnd;
+}
+
+static DNvec2 _DNUI_layout_text(const char* text, int len, DNUIfont* font, float scale, float maxW, int align, DNUItextLayout* layout)
+{
+	if(layout)
+	{
+		//codepoints take at least a byte each, so the glyph arrays never need to grow while laying out:
+		if(len > layout->glyphCapacity)
+		{
+			layout->glyphCapacity = len;
+			layout->codepoints = realloc(layout->codepoints, len * sizeof(uint32_t));
+			layout->positions = realloc(layout->positions, len * sizeof(DNvec2));
+			layout->textOffsets = realloc(layout->textOffsets, len * sizeof(int));
+		}
+
+		layout->numGlyphs = 0;
+		layout->numLines = 0;
+	}
+
+	//fonts still loading have no glyphs to lay out, so they're as tall as their size until ready:
+	//---------------------------------
+	DNvec2 size;
+	if(font->internal->loading)
+	{
+		size = (DNvec2){maxW > 0.0f ? maxW : 0.0f, font->internal->size * scale};
+		if(layout)
+		{
+			layout->size = size;
+			layout->lineHeight = size.y;
+		}
+
+		return size;
+	}
+
+	//break into lines:
+	//---------------------------------
+	if(maxW <= 0.0f)
+		size = (DNvec2){_DNUI_layout_line(text, 0, len, font, scale, layout), font->lineHeight * scale};
+	else
+	{
+		//the string's breaks are cached, so wrapping it again at a different width only walks over its words:
+		_DNUI_mutex_lock(layoutCacheMutex);
+		const _DNUIlineBreaks* breaks = _DNUI_get_line_breaks(text, len, font);
+
+		int numLines = 0;
+		int start = 0;
+		int word = 0;
+		bool skipFirst = false; //the first character of every line after the first is never wrapped, so each line has at least one
+		while(true)
+		{
+			int end = _DNUI_next_line_break(breaks, start, skipFirst, scale, maxW, &word);
+			if(end >= breaks->numChars)
+				break;
+
+			if(layout)
+				_DNUI_layout_line(text, breaks->offsets[start], breaks->offsets[end], font, scale, layout);
+
+			numLines++;
+			start = end;
+			skipFirst = true;
+		}
+
+		if(start < breaks->numChars)
+		{
+			if(layout)
+				_DNUI_layout_line(text, breaks->offsets[start], len, font, scale, layout);
+
+			numLines++;
+		}
+
+		_DNUI_mutex_unlock(layoutCacheMutex);
+
+		size = (DNvec2){maxW, numLines * font->lineHeight * scale};
+	}
+
+	if(layout)
+	{
+		layout->size = size;
+		layout->lineHeight = font->lineHeight * scale;
+		_DNUI_align_layout(layout, align);
+	}
+
+	return size;
+}
+
+static void _DNUI_align_layout(DNUItextLayout* layout, int align)
+{
+	for(int i = 0; i < layout->numLines; i++)
+	{
+		DNUItextLine* line = &layout->lines[i];
+		if(align == 1)
+			line->x = layout->size.x - line->w;
+		else if(align == 2)
+			line->x = (layout->size.x - line->w) * 0.5f;
+		else
+			line->x = 0.0f;
+	}
+}
+
+static float _DNUI_layout_line(const char* text, int start, int end, DNUIfont* font, float scale, DNUItextLayout* layout)
+{
+	DNUItextLine line = {layout ? layout->numGlyphs : 0, 0, start, end, 0.0f, 0.0f};
+
+	float w = 0.0f;
+	uint32_t prevCodepoint = 0;
+	int i = start;
+	while(i < end)
+	{
+		int run = 0;
+		while(i + run < end && (unsigned char)text[i + run] < DNUI_KERNING_TABLE_SIZE)
+			run++;
+
+		if(run > 0)
+		{
+			if(layout)
+			{
+				for(int j = 0; j < run; j++)
+				{
+					layout->codepoints[layout->numGlyphs + j] = (unsigned char)text[i + j];
+					layout->textOffsets[layout->numGlyphs + j] = i + j;
+				}
+			}
+
+			w = _DNUI_measure_ascii(font, &text[i], run, prevCodepoint, w, i + run >= end, scale, layout ? &layout->positions[layout->numGlyphs] : NULL);
+			if(layout)
+			{
+				layout->numGlyphs += run;
+				line.numGlyphs += run;
+			}
+
+			prevCodepoint = (unsigned char)text[i + run - 1];
+			i += run;
+			continue;
+		}
+
+		uint32_t codepoint;
+		int offset = i;
+		i += DNUI_utf8_decode_n(&text[i], end - i, &codepoint);
+		DNUIglyph* glyph = _DNUI_get_glyph(font, codepoint, false);
+
+		w += _DNUI_get_kerning(font, prevCodepoint, codepoint);
+		prevCodepoint = codepoint;
+
+		if(layout)
+		{
+			layout->codepoints[layout->numGlyphs] = codepoint;
+			layout->positions[layout->numGlyphs] = (DNvec2){w * scale, (w + glyph->advance) * scale};
+			layout->textOffsets[layout->numGlyphs] = offset;
+			layout->numGlyphs++;
+			line.numGlyphs++;
+		}
+
+		if(i >= end)
+			w += glyph->bmpL + glyph->bmpW;
+		else
+			w += glyph->advance;
+	}
+
+	line.w = w * scale;
+	if(layout)
+	{
+		if(layout->numLines >= layout->lineCapacity)
+		{
+			layout->lineCapacity = layout->lineCapacity > 0 ? layout->lineCapacity * 2 : 8;
+			layout->lines = realloc(layout->lines, layout->lineCapacity * sizeof(DNUItextLine));
+		}
+
+		layout->lines[layout->numLines++] = line;
+	}
+
+	return line.w;
+}
+
+static void _DNUI_draw_layout(const DNUItextLayout* layout, DNUIfont* font, float scale, DNvec2 pos, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+{
+	//make sure every glyph is in the atlas first, since adding one can move the others:
+	//---------------------------------
+	font->useStamp++;
+	for(int i = 0; i < layout->numGlyphs; i++)
+		_DNUI_get_glyph(font, layout->codepoints[i], true)->lastUsed = font->useStamp;
+
+	//queue glyphs, sending what's already queued first if it uses a different texture:
+	//---------------------------------
+	if(textBatchSize > 0 && textBatchTexture != font->textureAtlas)
+		_DNUI_flush_text();
+
+	textBatchTexture = font->textureAtlas;
+	textBatchFlags = font->internal->flags;
+
+	if(textBatchSize + 6 * layout->numGlyphs > textBatchCapacity)
+	{
+		textBatchCapacity = textBatchCapacity * 2 > textBatchSize + 6 * layout->numGlyphs ? textBatchCapacity * 2 : textBatchSize + 6 * layout->numGlyphs;
+		textBatch = realloc(textBatch, textBatchCapacity * sizeof(_DNUItextVertex));
+	}
+
+	_DNUItextVertex vertex = {0.0f, 0.0f, 0.0f, 0.0f, (GLfloat)font->atlasLayer, color, outlineColor, 1.0f - thickness, softness / scale, 1.0f - outlineThickness, outlineSoftness / scale};
+
+	//pos is the layout's center, lines are placed down from its top left:
+	float left = pos.x - layout->size.x * 0.5f;
+	float top = pos.y + layout->size.y * 0.5f;
+
+	for(int i = 0; i < layout->numLines; i++)
+	{
+		const DNUItextLine* line = &layout->lines[i];
+		float lineX = left + line->x;
+		float lineY = top - layout->lineHeight * i;
+
+		for(int j = line->firstGlyph; j < line->firstGlyph + line->numGlyphs; j++)
+		{
+			DNUIglyph* glyph = _DNUI_find_glyph(font, layout->codepoints[j]);
+
+			float x =  lineX + layout->positions[j].x + glyph->bmpL * scale;
+			float y = -lineY - (glyph->bmpT - font->maxBearing) * scale;
+			float w = glyph->bmpW * scale;
+			float h = glyph->bmpH * scale;
+
+			//don't render spaces, or glyphs that didn't fit in the atlas
+			if(w <= 0.0 || h <= 0.0 || !glyph->resident)
+				continue;
+
+			const GLfloat corners[6][4] = {
+				{x	  , -y	  , glyph->texL, glyph->texT},
+				{x + w, -y	  , glyph->texR, glyph->texT},
+				{x	  , -y - h, glyph->texL, glyph->texB},
+				{x + w, -y	  , glyph->texR, glyph->texT},
+				{x	  , -y - h, glyph->texL, glyph->texB},
+				{x + w, -y - h, glyph->texR, glyph->texB}
+			};
+
+			for(int k = 0; k < 6; k++)
+			{
+				vertex.x = corners[k][0];
+				vertex.y = corners[k][1];
+				vertex.texX = corners[k][2];
+				vertex.texY = corners[k][3];
+				textBatch[textBatchSize++] = vertex;
+			}
+		}
+	}
+
+	if(!textBatching)
+		_DNUI_flush_text();
+}
+
+void DNUI_draw_string(const char* text, DNUIfont* font, DNvec2 pos, float scale, float maxW, int align, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+{
+	DNUI_draw_string_n(text, strlen(text), font, pos, scale, maxW, align, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+}
+
+void DNUI_draw_string_n(const char* text, size_t len, DNUIfont* font, DNvec2 pos, float scale, float maxW, int align, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+{
+	//fonts loaded with DNUI_load_font_async() aren't drawn until they're ready, fonts loaded with DNUI_load_font_metrics() get their atlas the first time they're drawn:
+	if(font->internal->loading || (font->shared->textureAtlas == 0 && !DNUI_upload_font_atlas(font)))
+		return;
+
+	scale *= font->sizeScale;
+	font = font->shared;
+
+	_DNUI_mutex_lock(font->internal->mutex);
+	_DNUI_mutex_lock(layoutCacheMutex);
+
+	//strings that were only measured so far have no layout yet:
+	_DNUIlayoutCacheEntry* entry = _DNUI_get_cached_layout(text, (int)len, font, false, scale, maxW, true);
+	entry->pinned = true;
+	if(!entry->hasLayout)
+	{
+		entry->size = _DNUI_layout_text(text, (int)len, font, scale, maxW, align, &entry->layout);
+		entry->hasLayout = true;
+		entry->align = align;
+	}
+	else if(entry->align != align)
+	{
+		_DNUI_align_layout(&entry->layout, align);
+		entry->align = align;
+	}
+
+	//drawing can lock other fonts to resize their texture array, which would deadlock with threads measuring them if the cache was held:
+	_DNUI_mutex_unlock(layoutCacheMutex);
+	_DNUI_draw_layout(&entry->layout, font, scale, pos, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+
+	_DNUI_mutex_lock(layoutCacheMutex);
+	entry->pinned = false;
+	_DNUI_mutex_unlock(layoutCacheMutex);
+
+	_DNUI_mutex_unlock(font->internal->mutex);
+}
+
+void DNUI_draw_text_layout(const DNUItextLayout* layout, DNvec2 pos, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness)
+{
+	DNUIfont* font = layout->font;
+	if(font->internal->loading || (font->shared->textureAtlas == 0 && !DNUI_upload_font_atlas(font)))
+		return;
+
+	_DNUI_mutex_lock(font->internal->mutex);
+	_DNUI_draw_layout(layout, font->shared, layout->scale * font->sizeScale, pos, color, thickness, softness, outlineColor, outlineThickness, outlineSoftness);
+	_DNUI_mutex_unlock(font->internal->mutex);
+}
+
+static _DNUIlayoutCacheEntry* _DNUI_get_cached_layout(const char* text, int len, DNUIfont* font, bool lineBreaks, float scale, float maxW, bool create)
+{
+	if(lineBreaks)
+	{
+		scale = 0.0f;
+		maxW = 0.0f;
+	}
+
+	if(!layoutCache)
+	{
+		layoutCache = calloc(DNUI_LAYOUT_CACHE_SIZE, sizeof(_DNUIlayoutCacheEntry));
+		layoutCacheBuckets = malloc(DNUI_LAYOUT_CACHE_BUCKETS * sizeof(int));
+		for(int i = 0; i < DNUI_LAYOUT_CACHE_BUCKETS; i++)
+			layoutCacheBuckets[i] = -1;
+	}
+
+	//fnv-1a over the text, then the other parameters:
+	//---------------------------------
+	uint32_t hash = 2166136261u;
+	for(int i = 0; i < len; i++)
+		hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+
+	uint32_t params[4] = {(uint32_t)(uintptr_t)font, lineBreaks};
+	memcpy(&params[2], &scale, sizeof(float));
+	memcpy(&params[3], &maxW, sizeof(float));
+	for(int i = 0; i < 4; i++)
+		hash = (hash ^ params[i]) * 16777619u;
+
+	//find:
+	//---------------------------------
+	int bucket = hash & (DNUI_LAYOUT_CACHE_BUCKETS - 1);
+	for(int i = layoutCacheBuckets[bucket]; i != -1; i = layoutCache[i].bucketNext)
+	{
+		_DNUIlayoutCacheEntry* entry = &layoutCache[i];
+		if(entry->hash == hash && entry->font == font && entry->lineBreaks == lineBreaks && entry->scale == scale && entry->maxW == maxW && entry->len == len && memcmp(entry->text, text, len) == 0)
+		{
+			_DNUI_unlink_cached_layout(i);
+			_DNUI_push_cached_layout(i);
+			return entry;
+		}
+	}
+
+	if(!create)
+		return NULL;
+
+	//add, replacing the least recently used string if the cache is full. The size (and layout) are filled in by the caller:
+	//---------------------------------
+	if(layoutCacheFree == -1 && numLayoutCacheEntries == DNUI_LAYOUT_CACHE_SIZE)
+	{
+		int replaced = layoutCacheLast;
+		while(layoutCache[replaced].pinned)
+			replaced = layoutCache[replaced].lruPrev;
+
+		_DNUI_remove_cached_layout(replaced);
+	}
+
+	int index;
+	if(layoutCacheFree != -1)
+	{
+		index = layoutCacheFree;
+		layoutCacheFree = layoutCache[index].bucketNext;
+	}
+	else
+		index = numLayoutCacheEntries++;
+
+	_DNUIlayoutCacheEntry* entry = &layoutCache[index];
+	entry->hash = hash;
+	entry->text = malloc(len + 1); //never NULL, even for empty strings
+	memcpy(entry->text, text, len);
+	entry->len = len;
+	entry->font = font;
+	entry->lineBreaks = lineBreaks;
+	entry->scale = scale;
+	entry->maxW = maxW;
+	entry->hasLayout = false;
+
+	entry->bucketNext = layoutCacheBuckets[bucket];
+	layoutCacheBuckets[bucket] = index;
+	_DNUI_push_cached_layout(index);
+
+	return entry;
+}
+
+static void _DNUI_remove_cached_layout(int index)
+{
+	_DNUIlayoutCacheEntry* entry = &layoutCache[index];
+
+	int* link = &layoutCacheBuckets[entry->hash & (DNUI_LAYOUT_CACHE_BUCKETS - 1)];
+	while(*link != index)
+		link = &layoutCache[*link].bucketNext;
+	*link = entry->bucketNext;
+
+	_DNUI_unlink_cached_layout(index);
+
+	free(entry->text);
+	entry->text = NULL;
+	entry->bucketNext = layoutCacheFree;
+	layoutCacheFree = index;
+}
+
+static void _DNUI_clear_cached_layouts(DNUIfont* font)
+{
+	for(int i = 0; i < numLayoutCacheEntries; i++)
+		if(layoutCache[i].text && (!font || layoutCache[i].font == font))
+			_DNUI_remove_cached_layout(i);
+}
+
+static void _DNUI_unlink_cached_layout(int index)
+{
+	_DNUIlayoutCacheEntry* entry = &layoutCache[index];
+	if(entry->lruPrev != -1)
+		layoutCache[entry->lruPrev].lruNext = entry->lruNext;
+	else
+		layoutCacheFirst = entry->lruNext;
+
+	if(entry->lruNext != -1)
+		layoutCache[entry->lruNext].lruPrev = entry->lruPrev;
+	else
+		layoutCacheLast = entry->lruPrev;
+}
+
+static void _DNUI_push_cached_layout(int index)
+{
+	_DNUIlayoutCacheEntry* entry = &layoutCache[index];
+	entry->lruPrev = -1;
+	entry->lruNext = layoutCacheFirst;
+	if(layoutCacheFirst != -1)
+		layoutCache[layoutCacheFirst].lruPrev = index;
+	else
+		layoutCacheLast = index;
+
+	layoutCacheFirst = index;
+}
+
+static const _DNUIlineBreaks* _DNUI_get_line_breaks(const char* text, int len, DNUIfont* font)
+{
+	//the font and cache must both be locked:
+	_DNUIlayoutCacheEntry* entry = _DNUI_get_cached_layout(text, len, font, true, 0.0f, 0.0f, false);
+	if(!entry)
+	{
+		entry = _DNUI_get_cached_layout(text, len, font, true, 0.0f, 0.0f, true);
+		_DNUI_find_line_breaks(text, len, font, &entry->breaks);
+	}
+
+	return &entry->breaks;
+}
+
+static void _DNUI_find_line_breaks(const char* text, int len, DNUIfont* font, _DNUIlineBreaks* breaks)
+{
+	//codepoints take at least a byte each, so the arrays never need to grow while filling them:
+	if(len + 1 > breaks->charCapacity)
+	{
+		breaks->charCapacity = len + 1;
+		breaks->offsets = realloc(breaks->offsets, breaks->charCapacity * sizeof(int));
+		breaks->pen = realloc(breaks->pen, breaks->charCapacity * sizeof(float));
+		breaks->right = realloc(breaks->right, breaks->charCapacity * sizeof(float));
+	}
+
+	if((len + 1) / 2 > breaks->wordCapacity) //words are separated by at least one space
+	{
+		breaks->wordCapacity = (len + 1) / 2;
+		breaks->wordStarts = realloc(breaks->wordStarts, breaks->wordCapacity * sizeof(int));
+		breaks->wordEnds = realloc(breaks->wordEnds, breaks->wordCapacity * sizeof(int));
+		breaks->wordRights = realloc(breaks->wordRights, breaks->wordCapacity * sizeof(float));
+	}
+
+	breaks->numChars = 0;
+	breaks->numWords = 0;
+
+	float pen = 0.0f;
+	bool inWord = false;
+	uint32_t prevCodepoint = 0;
+	int i = 0;
+	while(i < len)
+	{
+		uint32_t codepoint;
+		int offset = i;
+		i += DNUI_utf8_decode_n(&text[i], len - i, &codepoint);
+		DNUIglyph* glyph = _DNUI_get_glyph(font, codepoint, false);
+
+		int c = breaks->numChars++;
+		float kerning = _DNUI_get_kerning(font, prevCodepoint, codepoint);
+		prevCodepoint = codepoint;
+
+		breaks->offsets[c] = offset;
+		breaks->pen[c] = pen;
+		breaks->right[c] = pen + kerning + glyph->bmpL + glyph->bmpW;
+		pen += kerning + glyph->advance;
+
+		//group into words:
+		//---------------------------------
+		if(codepoint < 128 && isspace(codepoint))
+			inWord = false;
+		else if(!inWord)
+		{
+			breaks->wordStarts[breaks->numWords] = c;
+			breaks->wordEnds[breaks->numWords] = c + 1;
+			breaks->wordRights[breaks->numWords] = breaks->right[c];
+			breaks->numWords++;
+			inWord = true;
+		}
+		else
+		{
+			float* wordRight = &breaks->wordRights[breaks->numWords - 1];
+			breaks->wordEnds[breaks->numWords - 1] = c + 1;
+			*wordRight = breaks->right[c] > *wordRight ? breaks->right[c] : *wordRight;
+		}
+	}
+
+	breaks->offsets[breaks->numChars] = len;
+	breaks->pen[breaks->numChars] = pen;
+}
+
+static int _DNUI_next_line_break(const _DNUIlineBreaks* breaks, int start, bool skipFirst, float scale, float maxW, int* word)
+{
+	//returns the character the line after the one at start begins at, or numChars if the rest of the string fits. Lines break before the first character
+	//that doesn't fit, moving back to the start of its word if that's on the line. word is the index of the first word that can end the line, advanced as lines are found
+	int first = skipFirst ? start + 1 : start;
+	if(first >= breaks->numChars)
+		return breaks->numChars;
+
+	float lineLeft = skipFirst ? breaks->pen[first] : 0.0f; //the first character's advance isn't counted, the first line's is
+
+	while(*word < breaks->numWords && breaks->wordEnds[*word] <= first)
+		(*word)++;
+
+	//only words that don't fit are checked character by character:
+	//---------------------------------
+	for(int w = *word; w < breaks->numWords; w++)
+	{
+		if((breaks->wordRights[w] - lineLeft) * scale <= maxW)
+			continue;
+
+		int wordStart = breaks->wordStarts[w];
+		for(int c = wordStart > first ? wordStart : first; c < breaks->wordEnds[w]; c++)
+		{
+			if((breaks->right[c] - lineLeft) * scale > maxW)
+			{
+				*word = w;
+				return wordStart - 1 <= start ? c : wordStart; //break inside the word if it started before the line, or at the line's first character
+			}
+		}
+	}
+
+	return breaks->numChars;
+}
+
+void DNUI_draw_string_simple(const char* text, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color)
+{
+	DNUI_draw_string_n(text, strlen(text), font, pos, scale, wrap, align, color, 0.5f, 0.05f, (DNvec4){0.0f, 0.0f, 0.0f, 0.0f}, 1.0f, 0.05f);
+}
+
+void DNUI_draw_string_simple_n(const char* text, size_t len, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color)
+{
+	DNUI_draw_string_n(text, len, font, pos, scale, wrap, align, color, 0.5f, 0.05f, (DNvec4){0.0f, 0.0f, 0.0f, 0.0f}, 1.0f, 0.05f);
+}
+
+void DNUI_begin_text_batch()
+{
+	textBatching = true;
+}
+
+void DNUI_end_text_batch()
+{
+	_DNUI_flush_text();
+	textBatching = false;
+}
+
+static void _DNUI_flush_text()
+{
+	if(textBatchSize == 0)
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, textBuffer);
+	glBufferData(GL_ARRAY_BUFFER, textBatchSize * sizeof(_DNUItextVertex), textBatch, GL_DYNAMIC_DRAW);
+
+	//2d atlases are bound to unit 0, texture arrays to unit 1:
+	bool useArray = (textBatchFlags & DNUI_FONT_TEXTURE_ARRAY) != 0;
+
+	glUseProgram(textProgram);
+	glUniformMatrix3fv(glGetUniformLocation(textProgram, "modelProjection"), 1, GL_FALSE, (GLfloat*)&projectionMat);
+	glUniform1i(glGetUniformLocation(textProgram, "textureAtlas"), 0);
+	glUniform1i(glGetUniformLocation(textProgram, "textureArray"), 1);
+	glUniform1ui(glGetUniformLocation(textProgram, "useArray"), useArray);
+	glUniform1ui(glGetUniformLocation(textProgram, "premultiplied"), premultipliedAlpha);
+	glUniform1ui(glGetUniformLocation(textProgram, "msdf"), (textBatchFlags & DNUI_FONT_MSDF) != 0);
+	glActiveTexture(useArray ? GL_TEXTURE1 : GL_TEXTURE0);
+	glBindTexture(useArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, textBatchTexture);
+	glActiveTexture(GL_TEXTURE0);
+
+	glBindVertexArray(textArray);
+	glDrawArrays(GL_TRIANGLES, 0, textBatchSize);
+
+	textBatchSize = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+void DNUI_draw_rect(int textureHandle, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_set_rect_uniforms(textureHandle, center, size, angle, color, cornerRad, outlineColor, outlineThickness);
+
+	glBindVertexArray(rectArray);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void DNUI_draw_rect_gradient(int textureHandle, const DNUIgradient* gradient, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_set_rect_uniforms(textureHandle, center, size, angle, color, cornerRad, outlineColor, outlineThickness);
+
+	int numStops = gradient->numStops;
+	if(numStops > DNUI_MAX_GRADIENT_STOPS)
+		numStops = DNUI_MAX_GRADIENT_STOPS;
+
+	glUniform1i(glGetUniformLocation(rectProgram, "gradientType"), numStops > 0 ? gradient->type : DNUI_GRADIENT_NONE);
+	glUniform2fv(glGetUniformLocation(rectProgram, "gradientStart"), 1, (GLfloat*)&gradient->start);
+	glUniform2fv(glGetUniformLocation(rectProgram, "gradientEnd"), 1, (GLfloat*)&gradient->end);
+	glUniform1i(glGetUniformLocation(rectProgram, "gradientNumStops"), numStops);
+	glUniform4fv(glGetUniformLocation(rectProgram, "gradientColors"), numStops, (GLfloat*)gradient->colors);
+	glUniform1fv(glGetUniformLocation(rectProgram, "gradientPositions"), numStops, gradient->positions);
+
+	glBindVertexArray(rectArray);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void DNUI_draw_rect_nine_slice(int textureHandle, DNvec4 insets, float borderScale, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_set_rect_uniforms(textureHandle, center, size, angle, color, cornerRad, outlineColor, outlineThickness);
+
+	glUniform1ui(glGetUniformLocation(rectProgram, "useNineSlice"), textureHandle >= 0);
+	glUniform4fv(glGetUniformLocation(rectProgram, "sliceInsets"), 1, (GLfloat*)&insets);
+	glUniform1f(glGetUniformLocation(rectProgram, "sliceScale"), borderScale);
+
+	glBindVertexArray(rectArray);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void DNUI_draw_rect_blurred(DNvec2 center, DNvec2 size, float angle, DNvec4 tint, float opacity, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	//don't generate the blur for rects that won't be seen:
+	//---------------------------------
+	float boundingRad = 0.5f * sqrtf(size.x * size.x + size.y * size.y);
+	if(opacity <= 0.0f || fabsf(center.x) - boundingRad > windowSize.x * 0.5f || fabsf(center.y) - boundingRad > windowSize.y * 0.5f)
+		return;
+
+	//blur the framebuffer, only done once per frame:
+	//---------------------------------
+	if(!blurGenerated)
+	{
+		_DNUI_generate_blur();
+		blurGenerated = true;
+	}
+
+	//draw:
+	//---------------------------------
+	_DNUI_set_rect_uniforms(-1, center, size, angle, tint, cornerRad, outlineColor, outlineThickness);
+
+	glUniform1ui(glGetUniformLocation(rectProgram, "useBlur"), true);
+	glUniform1i(glGetUniformLocation(rectProgram, "blurTex"), 1);
+	glUniform2f(glGetUniformLocation(rectProgram, "screenSize"), (float)blurW, (float)blurH);
+	glUniform1f(glGetUniformLocation(rectProgram, "blurOpacity"), opacity);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, blurTextures[1]);
+	glActiveTexture(GL_TEXTURE0);
+
+	glBindVertexArray(rectArray);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+void DNUI_draw_circle(DNvec2 center, float radius, DNvec4 color, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_draw_shape(DNUI_SHAPE_CIRCLE, &center, 1, radius, (DNvec4){radius, 0.0f, 0.0f, 0.0f}, color, 0.0f, outlineColor, outlineThickness);
+}
+
+void DNUI_draw_arc(DNvec2 center, float radius, float thickness, float startAngle, float endAngle, DNvec4 color, DNvec4 outlineColor, float outlineThickness)
+{
+	DNvec4 params = {radius, thickness * 0.5f, DN_deg_to_rad(startAngle), DN_deg_to_rad(endAngle)};
+	_DNUI_draw_shape(DNUI_SHAPE_ARC, &center, 1, radius + thickness * 0.5f, params, color, 0.0f, outlineColor, outlineThickness);
+}
+
+void DNUI_draw_line(DNvec2 start, DNvec2 end, float thickness, DNvec4 color, DNvec4 outlineColor, float outlineThickness)
+{
+	DNvec2 points[2] = {start, end};
+	_DNUI_draw_shape(DNUI_SHAPE_LINE, points, 2, thickness * 0.5f, (DNvec4){thickness * 0.5f, 0.0f, 0.0f, 0.0f}, color, 0.0f, outlineColor, outlineThickness);
+}
+
+void DNUI_draw_polyline(const DNvec2* points, int numPoints, float thickness, DNvec4 color, DNvec4 outlineColor, float outlineThickness)
+{
+	//split into chunks that fit in the shader, consecutive chunks share an endpoint:
+	for(int i = 0; i < numPoints - 1; i += DNUI_MAX_SHAPE_POINTS - 1)
+	{
+		int chunkPoints = numPoints - i < DNUI_MAX_SHAPE_POINTS ? numPoints - i : DNUI_MAX_SHAPE_POINTS;
+		_DNUI_draw_shape(DNUI_SHAPE_POLYLINE, &points[i], chunkPoints, thickness * 0.5f, (DNvec4){thickness * 0.5f, 0.0f, 0.0f, 0.0f}, color, 0.0f, outlineColor, outlineThickness);
+	}
+}
+
+void DNUI_draw_triangle(DNvec2 a, DNvec2 b, DNvec2 c, float cornerRad, DNvec4 color, DNvec4 outlineColor, float outlineThickness)
+{
+	DNvec2 points[3] = {a, b, c};
+	_DNUI_draw_shape(DNUI_SHAPE_TRIANGLE, points, 3, cornerRad, (DNvec4){0.0f, 0.0f, 0.0f, 0.0f}, color, cornerRad, outlineColor, outlineThickness);
+}
+
+//draws a shape in the rect shader, using a quad that covers every point plus padding pixels
+static void _DNUI_draw_shape(int shape, const DNvec2* points, int numPoints, float padding, DNvec4 params, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_flush_text(); //so queued text stays behind the shape
+	//find bounding quad:
+	//---------------------------------
+	DNvec2 minPos = points[0];
+	DNvec2 maxPos = points[0];
+	for(int i = 1; i < numPoints; i++)
+	{
+		minPos = DN_vec2_min(minPos, points[i]);
+		maxPos = DN_vec2_max(maxPos, points[i]);
+	}
+
+	padding += 2.0f; //leave room for antialiasing
+	DNvec2 center = DN_vec2_scale(DN_vec2_add(minPos, maxPos), 0.5f);
+	DNvec2 size = {maxPos.x - minPos.x + 2.0f * padding, maxPos.y - minPos.y + 2.0f * padding};
+
+	//convert points to be relative to quad:
+	//---------------------------------
+	DNvec2 relPoints[DNUI_MAX_SHAPE_POINTS];
+	for(int i = 0; i < numPoints; i++)
+		relPoints[i] = DN_vec2_sub(points[i], center);
+
+	//draw:
+	//---------------------------------
+	_DNUI_set_rect_uniforms(-1, center, size, 0.0f, color, cornerRad, outlineColor, outlineThickness);
+
+	glUniform1i(glGetUniformLocation(rectProgram, "shape"), shape);
+	glUniform4fv(glGetUniformLocation(rectProgram, "shapeParams"), 1, (GLfloat*)&params);
+	glUniform2fv(glGetUniformLocation(rectProgram, "shapePoints"), numPoints, (GLfloat*)relPoints);
+	glUniform1i(glGetUniformLocation(rectProgram, "shapeNumPoints"), numPoints);
+
+	glBindVertexArray(rectArray);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+//sets all of the rect shader's uniforms, with every optional effect disabled
+static void _DNUI_set_rect_uniforms(int textureHandle, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+{
+	_DNUI_flush_text(); //so queued text stays behind the rect
+	DNmat3 model = DN_mat3_translate(center);
+	model = DN_mat3_mult(model, DN_mat3_rotate(angle));
+	model = DN_mat3_mult(model, DN_mat3_scale((DNvec2){size.x * 0.5f, size.y * 0.5f}));
+
+	model = DN_mat3_mult(projectionMat, model);
+
+	glUseProgram(rectProgram);
+
+	glUniformMatrix3fv(glGetUniformLocation(rectProgram, "modelProjection"), 1, GL_FALSE, (GLfloat*)&model);
+	glUniform4fv(glGetUniformLocation(rectProgram, "color"), 1, (GLfloat*)&color);
+	glUniform2fv(glGetUniformLocation(rectProgram, "size"), 1, (GLfloat*)&size);
+	glUniform1f(glGetUniformLocation(rectProgram, "cornerRad"), cornerRad);
+
+	glUniform4fv(glGetUniformLocation(rectProgram, "outlineColor"), 1, (GLfloat*)&outlineColor);
+	glUniform1f(glGetUniformLocation(rectProgram, "outlineThickness"), outlineThickness);
+
+	glUniform1ui(glGetUniformLocation(rectProgram, "useTex"), textureHandle >= 0);
+	glUniform1i(glGetUniformLocation(rectProgram, "tex"), 0);
+	glUniform1ui(glGetUniformLocation(rectProgram, "premultiplied"), premultipliedAlpha);
+
+	glUniform1i(glGetUniformLocation(rectProgram, "shape"), DNUI_SHAPE_RECT);
+	glUniform1ui(glGetUniformLocation(rectProgram, "useNineSlice"), false);
+	glUniform1ui(glGetUniformLocation(rectProgram, "useBlur"), false);
+	glUniform1i(glGetUniformLocation(rectProgram, "gradientType"), DNUI_GRADIENT_NONE);
+
+	if(textureHandle >= 0)
+	{
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, textureHandle);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static void _DNUI_create_blur_targets(unsigned int w, unsigned int h)
+{
+	if(blurW > 0)
+	{
+		glDeleteTextures(DNUI_BLUR_PASSES + 1, blurTextures);
+		glDeleteFramebuffers(DNUI_BLUR_PASSES + 1, blurFramebuffers);
+	}
+
+	glGenTextures(DNUI_BLUR_PASSES + 1, blurTextures);
+	glGenFramebuffers(DNUI_BLUR_PASSES + 1, blurFramebuffers);
+
+	for(int i = 0; i <= DNUI_BLUR_PASSES; i++)
+	{
+		unsigned int levelW = w >> i > 0 ? w >> i : 1;
+		unsigned int levelH = h >> i > 0 ? h >> i : 1;
+
+		glBindTexture(GL_TEXTURE_2D, blurTextures[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, levelW, levelH, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, blurFramebuffers[i]);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blurTextures[i], 0);
+	}
+
+	blurW = w;
+	blurH = h;
+}
+
+static void _DNUI_generate_blur()
+{
+	_DNUI_flush_text(); //so queued text is included in the blur
+	//save state:
+	//---------------------------------
+	GLint drawFramebuffer, readFramebuffer;
+	GLint viewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+
+	if(blurW != (unsigned int)windowSize.x || blurH != (unsigned int)windowSize.y)
+		_DNUI_create_blur_targets((unsigned int)windowSize.x, (unsigned int)windowSize.y);
+
+	//capture the framebuffer at full resolution (also resolves multisampling):
+	//---------------------------------
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, drawFramebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, blurFramebuffers[0]);
+	glBlitFramebuffer(0, 0, blurW, blurH, 0, 0, blurW, blurH, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	//downsample, then upsample back to half resolution:
+	//---------------------------------
+	glDisable(GL_BLEND);
+	glUseProgram(blurProgram);
+
+	DNmat3 identity = DN_mat3_identity();
+	glUniformMatrix3fv(glGetUniformLocation(blurProgram, "modelProjection"), 1, GL_FALSE, (GLfloat*)&identity);
+	glUniform1i(glGetUniformLocation(blurProgram, "tex"), 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindVertexArray(rectArray);
+
+	for(int pass = 0; pass < 2 * DNUI_BLUR_PASSES - 1; pass++)
+	{
+		bool upsample = pass >= DNUI_BLUR_PASSES;
+		int src = upsample ? 2 * DNUI_BLUR_PASSES - pass : pass;
+		int dst = upsample ? src - 1 : src + 1;
+
+		unsigned int dstW = blurW >> dst > 0 ? blurW >> dst : 1;
+		unsigned int dstH = blurH >> dst > 0 ? blurH >> dst : 1;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, blurFramebuffers[dst]);
+		glViewport(0, 0, dstW, dstH);
+		glBindTexture(GL_TEXTURE_2D, blurTextures[src]);
+		glUniform2f(glGetUniformLocation(blurProgram, "halfPixel"), 0.5f / dstW, 0.5f / dstH);
+		glUniform1ui(glGetUniformLocation(blurProgram, "upsample"), upsample);
+
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+
+	//restore state:
+	//---------------------------------
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	if(blendEnabled)
+		glEnable(GL_BLEND);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static void _DNUI_font_worker(void* data)
+{
+	_DNUIfontWorker* worker = data;
+	worker->arena = NULL;
+	worker->arenaSize = 0;
+
+	//create face, each worker needs its own library since they are not thread safe:
+	//---------------------------------
+	FT_Library lib = worker->lib;
+	if(!lib && FT_Init_FreeType(&lib))
+	{
+		worker->failed = true;
+		return;
+	}
+
+	FT_Face font;
+	if(FT_New_Memory_Face(lib, worker->fontData, (FT_Long)worker->fontDataSize, worker->faceIndex, &font))
+	{
+		if(!worker->lib)
+			FT_Done_FreeType(lib);
+
+		worker->failed = true;
+		return;
+	}
+
+	FT_Set_Pixel_Sizes(font, 0, worker->size);
+
+	//render glyphs into the arena:
+	//---------------------------------
+	int channels = _DNUI_get_atlas_channels(worker->flags);
+	size_t arenaCapacity = (worker->numCodepoints / worker->stride + 1) * (size_t)worker->size * worker->size * channels;
+	worker->arena = malloc(arenaCapacity);
+
+	for(int i = worker->first; i < worker->numCodepoints; i += worker->stride)
+	{
+		//glyphs the font lacks are loaded on first use instead, so fallback fonts can provide them
+		uint32_t codepoint = worker->codepoints[i];
+		FT_UInt glyphIndex = FT_Get_Char_Index(font, codepoint);
+		if(glyphIndex == 0)
+			continue;
+
+		_DNUIrenderedGlyph rendered;
+		if(!_DNUI_render_glyph(font, glyphIndex, worker->flags, &rendered))
+		{
+			printf("DNUI ERROR - FAILED TO LOAD CHARACTER U+%04X\n", codepoint);
+			continue;
+		}
+
+		size_t rowSize = (size_t)rendered.w * channels;
+		size_t bitmapSize = rowSize * rendered.h;
+		if(worker->arenaSize + bitmapSize > arenaCapacity)
+		{
+			while(worker->arenaSize + bitmapSize > arenaCapacity)
+				arenaCapacity *= 2;
+
+			worker->arena = realloc(worker->arena, arenaCapacity);
+		}
+
+		for(unsigned int y = 0; y < rendered.h; y++)
+			memcpy(&worker->arena[worker->arenaSize + y * rowSize], &rendered.pixels[y * rendered.pitch], rowSize);
+
+		if(rendered.allocated)
+			free(rendered.pixels);
+
+		//set data:
+		_DNUIglyphBitmap* glyph = &worker->glyphs[i];
+		glyph->loaded = true;
+		glyph->worker = worker->first;
+		glyph->arenaPos = worker->arenaSize;
+		glyph->advance = rendered.advance;
+		glyph->w = rendered.w;
+		glyph->h = rendered.h;
+		glyph->l = rendered.l;
+		glyph->t = rendered.t;
+
+		worker->arenaSize += bitmapSize;
+	}
+
+	FT_Done_Face(font);
+	if(!worker->lib)
+		FT_Done_FreeType(lib);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static bool _DNUI_render_glyphs(FT_Library lib, const unsigned char* fontData, size_t fontDataSize, int faceIndex, int size, unsigned int flags, const uint32_t* codepoints, int numCodepoints, _DNUIglyphBitmap* glyphs, _DNUIfontWorker* workers, unsigned int* numWorkers)
+{
+	unsigned int count = fontLoadThreads > 0 ? fontLoadThreads : _DNUI_get_core_count();
+	if(count > DNUI_MAX_FONT_WORKERS)
+		count = DNUI_MAX_FONT_WORKERS;
+	if(count > (unsigned int)numCodepoints)
+		count = numCodepoints > 0 ? numCodepoints : 1;
+
+	//the calling thread acts as the first worker:
+	//---------------------------------
+	_DNUIthread* threads[DNUI_MAX_FONT_WORKERS] = {0};
+	for(unsigned int i = 0; i < count; i++)
+	{
+		_DNUIfontWorker* worker = &workers[i];
+		worker->lib = i == 0 ? lib : NULL;
+		worker->fontData = fontData;
+		worker->fontDataSize = fontDataSize;
+		worker->faceIndex = faceIndex;
+		worker->size = size;
+		worker->flags = flags;
+		worker->codepoints = codepoints;
+		worker->numCodepoints = numCodepoints;
+		worker->first = i;
+		worker->stride = count;
+		worker->glyphs = glyphs;
+		worker->failed = false;
+
+		if(i > 0)
+			threads[i] = _DNUI_thread_create(_DNUI_font_worker, worker);
+	}
+
+	_DNUI_font_worker(&workers[0]);
+
+	//workers that failed to start are run on the calling thread instead:
+	bool failed = false;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		if(i > 0)
+		{
+			if(threads[i])
+				_DNUI_thread_join(threads[i]);
+			else
+				_DNUI_font_worker(&workers[i]);
+		}
+
+		failed = failed || workers[i].failed;
+	}
+
+	if(failed)
+	{
+		for(unsigned int i = 0; i < count; i++)
+			free(workers[i].arena);
+
+		return false;
+	}
+
+	*numWorkers = count;
+	return true;
+}
+
+static unsigned char* _DNUI_pack_glyphs(_DNUIglyphBitmap* glyphs, int numGlyphs, const _DNUIfontWorker* workers, int channels, int maxSize, int* w, int* h, _DNUIskyline* skyline)
+{
+	_DNUIatlasRect* rects = malloc((numGlyphs > 0 ? numGlyphs : 1) * sizeof(_DNUIatlasRect));
+	int numRects = 0;
+	size_t area = 0;
+
+	for(int i = 0; i < numGlyphs; i++)
+	{
+		if(!glyphs[i].loaded || glyphs[i].w == 0 || glyphs[i].h == 0)
+			continue;
+
+		rects[numRects++] = (_DNUIatlasRect){i, glyphs[i].w, glyphs[i].h, 0, 0};
+		area += (size_t)(glyphs[i].w + DNUI_ATLAS_PADDING) * (glyphs[i].h + DNUI_ATLAS_PADDING);
+	}
+
+	//start with the smallest square that could fit every glyph, doubling the width until they all fit without the atlas getting taller than it is wide:
+	//---------------------------------
+	*w = 1;
+	while((size_t)*w * *w < area)
+		*w *= 2;
+
+	while(!_DNUI_pack_atlas(rects, numRects, *w, h, skyline))
+	{
+		*w *= 2;
+		if(*w > maxSize)
+		{
+			free(rects);
+			return NULL;
+		}
+	}
+
+	skyline->h = *h;
+
+	//copy bitmaps into atlas image:
+	//---------------------------------
+	unsigned char* atlas = calloc((size_t)*w * *h, channels);
+	for(int i = 0; i < numRects; i++)
+	{
+		_DNUIglyphBitmap* glyph = &glyphs[rects[i].glyph];
+		glyph->atlasX = rects[i].x;
+		glyph->atlasY = rects[i].y;
+
+		unsigned char* bitmap = &workers[glyph->worker].arena[glyph->arenaPos];
+		for(unsigned int y = 0; y < glyph->h; y++)
+			memcpy(&atlas[((size_t)(rects[i].y + y) * *w + rects[i].x) * channels], &bitmap[y * glyph->w * channels], glyph->w * channels);
+	}
+
+	free(rects);
+	return atlas;
+}
+
+static void _DNUI_get_line_metrics(const _DNUIglyphBitmap* glyphs, const uint32_t* codepoints, int numGlyphs, float* maxBearing, float* lineHeight)
+{
+	//only ascii glyphs are used if there are any, so tall glyphs from other scripts don't change the line spacing:
+	bool hasAscii = false;
+	for(int i = 0; i < numGlyphs && !hasAscii; i++)
+		hasAscii = glyphs[i].loaded && codepoints[i] < 128;
+
+	*maxBearing = 0.0f;
+	*lineHeight = 0.0f;
+	for(int i = 0; i < numGlyphs; i++)
+	{
+		if(!glyphs[i].loaded || (hasAscii && codepoints[i] >= 128))
+			continue;
+
+		*maxBearing = glyphs[i].t > *maxBearing ? glyphs[i].t : *maxBearing;
+		*lineHeight = glyphs[i].h > *lineHeight ? glyphs[i].h : *lineHeight;
+	}
+}
+
+static void _DNUI_get_kerning_pairs(const unsigned char* fontData, size_t fontDataSize, int size, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs)
+{
+	*pairs = NULL;
+	*numPairs = 0;
+
+	FT_Library lib = freetypeLib;
+	if(!lib && FT_Init_FreeType(&lib))
+		return;
+
+	FT_Face face;
+	if(!FT_New_Memory_Face(lib, (const FT_Byte*)fontData, (FT_Long)fontDataSize, 0, &face))
+	{
+		FT_Set_Pixel_Sizes(face, 0, size);
+
+		//sfnt fonts keep their pairs in a kern table, which is read directly so baking doesn't ask freetype about every pair of glyphs:
+		FT_ULong tableSize = 0;
+		if(FT_HAS_KERNING(face) && !FT_Load_Sfnt_Table(face, TTAG_kern, 0, NULL, &tableSize))
+			_DNUI_read_kern_table(face, tableSize, glyphs, numGlyphs, pairs, numPairs);
+		else if(FT_HAS_KERNING(face))
+			_DNUI_scan_kerning_pairs(face, glyphs, numGlyphs, pairs, numPairs);
+
+		FT_Done_Face(face);
+	}
+
+	if(lib != freetypeLib)
+		FT_Done_FreeType(lib);
+}
+
+static inline unsigned int _DNUI_read_be16(const unsigned char* p)
+{
+	return (unsigned int)p[0] << 8 | p[1];
+}
+
+static void _DNUI_read_kern_table(FT_Face face, FT_ULong tableSize, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs)
+{
+	unsigned char* table = malloc(tableSize > 0 ? tableSize : 1);
+	if(FT_Load_Sfnt_Table(face, TTAG_kern, 0, table, &tableSize) || tableSize < 4)
+	{
+		free(table);
+		return;
+	}
+
+	//sort the baked glyphs by their index in the font, several codepoints can share a glyph:
+	//---------------------------------
+	_DNUIbakedGlyphIndex* indices = malloc((numGlyphs > 0 ? numGlyphs : 1) * sizeof(_DNUIbakedGlyphIndex));
+	uint32_t numIndices = 0;
+	for(uint32_t i = 0; i < numGlyphs; i++)
+	{
+		FT_UInt index = FT_Get_Char_Index(face, glyphs[i].codepoint);
+		if(index != 0)
+			indices[numIndices++] = (_DNUIbakedGlyphIndex){index, i};
+	}
+
+	qsort(indices, numIndices, sizeof(_DNUIbakedGlyphIndex), _DNUI_compare_baked_glyph_indices);
+
+	//collect the entries between baked glyphs, only subtables FT_Get_Kerning() would use are read (version 0, format 0, horizontal, not minimums or cross-stream):
+	//---------------------------------
+	uint32_t numEntries = 0;
+	uint32_t maxEntries = 64;
+	_DNUIkernTableEntry* entries = malloc(maxEntries * sizeof(_DNUIkernTableEntry));
+
+	const unsigned char* end = table + tableSize;
+	const unsigned char* subtable = table + 4;
+	unsigned int numSubtables = _DNUI_read_be16(table) == 0 ? _DNUI_read_be16(table + 2) : 0;
+	for(unsigned int t = 0; t < numSubtables && end - subtable >= 14; t++)
+	{
+		//the length field is only 16 bits, large subtables overflow it, so the last one always extends to the end of the table:
+		size_t length = _DNUI_read_be16(subtable + 2);
+		const unsigned char* next = (t == numSubtables - 1 || length < 14 || length > (size_t)(end - subtable)) ? end : subtable + length;
+
+		unsigned int coverage = _DNUI_read_be16(subtable + 4);
+		if((coverage & ~0x0008u) != 0x0001)
+		{
+			subtable = next;
+			continue;
+		}
+
+		const unsigned char* entry = subtable + 14;
+		unsigned int count = _DNUI_read_be16(subtable + 6);
+		if(count > (next - entry) / 6)
+			count = (unsigned int)((next - entry) / 6);
+
+		for(unsigned int i = 0; i < count; i++, entry += 6)
+		{
+			FT_UInt left = _DNUI_read_be16(entry);
+			FT_UInt right = _DNUI_read_be16(entry + 2);
+
+			uint32_t l = _DNUI_find_baked_glyph_index(indices, numIndices, left);
+			uint32_t r = _DNUI_find_baked_glyph_index(indices, numIndices, right);
+			if(l >= numIndices || indices[l].index != left || r >= numIndices || indices[r].index != right)
+				continue;
+
+			if(numEntries >= maxEntries)
+			{
+				maxEntries *= 2;
+				entries = realloc(entries, maxEntries * sizeof(_DNUIkernTableEntry));
+			}
+
+			entries[numEntries] = (_DNUIkernTableEntry){left, right, numEntries, (int16_t)_DNUI_read_be16(entry + 4), (coverage & 0x0008) != 0};
+			numEntries++;
+		}
+
+		subtable = next;
+	}
+
+	//combine each pair's entries and scale them like FT_KERNING_UNFITTED, then write them for every codepoint sharing the glyphs:
+	//---------------------------------
+	qsort(entries, numEntries, sizeof(_DNUIkernTableEntry), _DNUI_compare_kern_table_entries);
+
+	uint32_t maxPairs = 0;
+	for(uint32_t i = 0; i < numEntries;)
+	{
+		FT_Pos value = 0;
+		uint32_t j = i;
+		for(; j < numEntries && entries[j].left == entries[i].left && entries[j].right == entries[i].right; j++)
+			value = entries[j].override ? entries[j].value : value + entries[j].value;
+
+		FT_Pos x = FT_MulFix(value, face->size->metrics.x_scale);
+		if(x != 0)
+		{
+			for(uint32_t l = _DNUI_find_baked_glyph_index(indices, numIndices, entries[i].left); l < numIndices && indices[l].index == entries[i].left; l++)
+			for(uint32_t r = _DNUI_find_baked_glyph_index(indices, numIndices, entries[i].right); r < numIndices && indices[r].index == entries[i].right; r++)
+				_DNUI_push_baked_kerning_pair(pairs, numPairs, &maxPairs, glyphs[indices[l].glyph].codepoint, glyphs[indices[r].glyph].codepoint, x / 64.0f);
+		}
+
+		i = j;
+	}
+
+	free(entries);
+	free(indices);
+	free(table);
+}
+
+static void _DNUI_scan_kerning_pairs(FT_Face face, const _DNUIbakedGlyph* glyphs, uint32_t numGlyphs, _DNUIbakedKerningPair** pairs, uint32_t* numPairs)
+{
+	//fonts without a kern table can only be asked pair by pair, so only the pairs of the dense kerning table are baked:
+	FT_UInt indices[DNUI_KERNING_TABLE_SIZE];
+	uint32_t codepoints[DNUI_KERNING_TABLE_SIZE];
+	int numIndices = 0;
+	for(uint32_t i = 0; i < numGlyphs; i++)
+	{
+		if(glyphs[i].codepoint >= DNUI_KERNING_TABLE_SIZE)
+			continue;
+
+		FT_UInt index = FT_Get_Char_Index(face, glyphs[i].codepoint);
+		if(index != 0 && numIndices < DNUI_KERNING_TABLE_SIZE)
+		{
+			indices[numIndices] = index;
+			codepoints[numIndices++] = glyphs[i].codepoint;
+		}
+	}
+
+	uint32_t maxPairs = 0;
+	for(int l = 0; l < numIndices; l++)
+	for(int r = 0; r < numIndices; r++)
+	{
+		FT_Vector kerning;
+		if(!FT_Get_Kerning(face, indices[l], indices[r], FT_KERNING_UNFITTED, &kerning) && kerning.x != 0)
+			_DNUI_push_baked_kerning_pair(pairs, numPairs, &maxPairs, codepoints[l], codepoints[r], kerning.x / 64.0f);
+	}
+}
+
+static void _DNUI_push_baked_kerning_pair(_DNUIbakedKerningPair** pairs, uint32_t* numPairs, uint32_t* maxPairs, uint32_t left, uint32_t right, float x)
+{
+	if(*numPairs >= *maxPairs)
+	{
+		*maxPairs = *maxPairs > 0 ? *maxPairs * 2 : 64;
+		*pairs = realloc(*pairs, *maxPairs * sizeof(_DNUIbakedKerningPair));
+	}
+
+	(*pairs)[(*numPairs)++] = (_DNUIbakedKerningPair){left, right, x};
+}
+
+static int _DNUI_compare_baked_glyph_indices(const void* a, const void* b)
+{
+	FT_UInt indexA = ((const _DNUIbakedGlyphIndex*)a)->index;
+	FT_UInt indexB = ((const _DNUIbakedGlyphIndex*)b)->index;
+	return (indexA > indexB) - (indexA < indexB);
+}
+
+static int _DNUI_compare_kern_table_entries(const void* a, const void* b)
+{
+	const _DNUIkernTableEntry* entryA = (const _DNUIkernTableEntry*)a;
+	const _DNUIkernTableEntry* entryB = (const _DNUIkernTableEntry*)b;
+	if(entryA->left != entryB->left)
+		return (entryA->left > entryB->left) - (entryA->left < entryB->left);
+	if(entryA->right != entryB->right)
+		return (entryA->right > entryB->right) - (entryA->right < entryB->right);
+
+	return (entryA->order > entryB->order) - (entryA->order < entryB->order);
+}
+
+static uint32_t _DNUI_find_baked_glyph_index(const _DNUIbakedGlyphIndex* indices, uint32_t numIndices, FT_UInt index)
+{
+	//returns the first entry with the index, or where it would be if it isn't baked:
+	uint32_t first = 0;
+	uint32_t last = numIndices;
+	while(first < last)
+	{
+		uint32_t mid = (first + last) / 2;
+		if(indices[mid].index < index)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	return first;
+}
+
+static DNUIfont* _DNUI_create_font(int size, unsigned int numGlyphs)
+{
+	DNUIfont* res = calloc(1, sizeof(DNUIfont));
+	res->internal = calloc(1, sizeof(_DNUIfontInternal));
+	res->internal->size = size;
+
+	res->glyphCapacity = DNUI_MIN_GLYPH_TABLE_SIZE;
+	while(res->glyphCapacity < numGlyphs * 2)
+		res->glyphCapacity *= 2;
+	res->glyphs = calloc(res->glyphCapacity, sizeof(DNUIglyph));
+
+	res->internal->mutex = _DNUI_mutex_create();
+	res->sizeScale = 1.0f;
+
+	if(!layoutCacheMutex)
+		layoutCacheMutex = _DNUI_mutex_create();
+	res->shared = res;
+
+	//cache straight away, handles are created from the cached font:
+	if(numCachedFonts >= maxCachedFonts)
+	{
+		maxCachedFonts = maxCachedFonts > 0 ? maxCachedFonts * 2 : 8;
+		fontCache = realloc(fontCache, maxCachedFonts * sizeof(DNUIfont*));
+	}
+
+	fontCache[numCachedFonts++] = res;
+	return res;
+}
+
+static DNUIfont* _DNUI_create_font_handle(DNUIfont* shared, int size)
+{
+	DNUIfont* res = calloc(1, sizeof(DNUIfont));
+	res->shared = shared;
+	res->internal = shared->internal;
+	res->sizeScale = (float)size / shared->internal->size;
+	res->textureAtlas = shared->textureAtlas;
+	res->atlasLayer = shared->atlasLayer;
+
+	//fonts still loading have no metrics yet, the size stands in until _DNUI_update_font_handles():
+	if(shared->internal->loading)
+	{
+		res->maxBearing = (float)size;
+		res->lineHeight = (float)size;
+	}
+	else
+	{
+		res->maxBearing = shared->maxBearing * res->sizeScale;
+		res->lineHeight = shared->lineHeight * res->sizeScale;
+	}
+
+	_DNUIfontInternal* internal = shared->internal;
+	if(internal->numHandles >= internal->maxHandles)
+	{
+		internal->maxHandles = internal->maxHandles > 0 ? internal->maxHandles * 2 : 4;
+		internal->handles = realloc(internal->handles, internal->maxHandles * sizeof(DNUIfont*));
+	}
+
+	internal->handles[internal->numHandles++] = res;
+	return res;
+}
+
+static void _DNUI_update_font_handles(DNUIfont* shared)
+{
+	for(int i = 0; i < shared->internal->numHandles; i++)
+	{
+		DNUIfont* handle = shared->internal->handles[i];
+		handle->textureAtlas = shared->textureAtlas;
+		handle->atlasLayer = shared->atlasLayer;
+		handle->maxBearing = shared->maxBearing * handle->sizeScale;
+		handle->lineHeight = shared->lineHeight * handle->sizeScale;
+	}
+}
+
+static bool _DNUI_render_atlas(DNUIfont* font, FT_Library lib)
+{
+	_DNUIfontInternal* internal = font->internal;
+
+	//render the printable ascii measured when the font was loaded, everything else is rendered on first use:
+	//---------------------------------
+	uint32_t codepoints[96];
+	int numCodepoints = 0;
+	for(uint32_t codepoint = 32; codepoint < 128; codepoint++)
+	{
+		DNUIglyph* glyph = _DNUI_find_glyph(font, codepoint);
+		if(glyph->loaded && !glyph->resident && FT_Get_Char_Index(internal->faces[0], codepoint) != 0)
+			codepoints[numCodepoints++] = codepoint;
+	}
+
+	_DNUIglyphBitmap glyphs[96] = {0};
+	_DNUIfontWorker workers[DNUI_MAX_FONT_WORKERS];
+	unsigned int numWorkers;
+	if(!_DNUI_render_glyphs(lib, internal->faceFiles[0]->data, internal->faceFiles[0]->size, internal->faceIndex, internal->size, internal->flags, codepoints, numCodepoints, glyphs, workers, &numWorkers))
+	{
+		printf("DNUI ERROR - FAILED TO LOAD FONT \"%s\"\n", internal->path);
+		return false;
+	}
+
+	int w, h;
+	unsigned char* atlas = _DNUI_pack_glyphs(glyphs, numCodepoints, workers, _DNUI_get_atlas_channels(internal->flags), maxFontAtlasSize, &w, &h, &internal->skyline);
+
+	for(unsigned int i = 0; i < numWorkers; i++)
+		free(workers[i].arena);
+
+	if(!atlas)
+	{
+		printf("DNUI ERROR - FONT \"%s\" AT SIZE %d DOES NOT FIT IN A TEXTURE\n", internal->path, internal->size);
+		return false;
+	}
+
+	internal->atlasImage = atlas;
+	font->atlasW = w;
+	font->atlasH = h;
+
+	for(int i = 0; i < numCodepoints; i++)
+	{
+		if(!glyphs[i].loaded)
+			continue;
+
+		DNUIglyph* glyph = _DNUI_find_glyph(font, codepoints[i]);
+		glyph->resident = true;
+		glyph->atlasX = glyphs[i].atlasX;
+		glyph->atlasY = glyphs[i].atlasY;
+	}
+
+	return true;
+}
+
+static bool _DNUI_create_atlas(DNUIfont* font)
+{
+	//asynchronously loaded fonts already rendered their atlas on the load thread:
+	if(!font->internal->atlasImage && !_DNUI_render_atlas(font, freetypeLib))
+		return false;
+
+	//texture coordinates depend on the texture's size, so are only set once it's created:
+	//---------------------------------
+	font->textureAtlas = _DNUI_create_atlas_texture(font);
+	for(unsigned int i = 0; i < font->glyphCapacity; i++)
+		if(font->glyphs[i].loaded && font->glyphs[i].resident)
+			_DNUI_set_glyph_tex_coords(font, &font->glyphs[i]);
+
+	_DNUI_upload_atlas(font, font->internal->atlasImage);
+	return true;
+}
+
+static GLuint _DNUI_create_atlas_texture(DNUIfont* font)
+{
+	//fonts in a texture array take the first layer no other font is using, adding layers if they all are:
+	//---------------------------------
+	unsigned int flags = font->internal->flags;
+	if(flags & DNUI_FONT_TEXTURE_ARRAY)
+	{
+		_DNUIfontArray* array = _DNUI_get_font_array(flags);
+
+		bool* used = calloc(array->numLayers + 1, sizeof(bool));
+		for(int i = 0; i < numCachedFonts; i++)
+			if(fontCache[i] != font && fontCache[i]->textureAtlas != 0 && (fontCache[i]->internal->flags & DNUI_FONT_TEXTURE_ARRAY) && _DNUI_get_font_array(fontCache[i]->internal->flags) == array)
+				used[fontCache[i]->atlasLayer] = true;
+
+		int layer = 0;
+		while(layer < array->numLayers && used[layer])
+			layer++;
+
+		free(used);
+		font->atlasLayer = layer;
+
+		int w = (int)font->atlasW > array->w ? (int)font->atlasW : array->w;
+		int h = (int)font->atlasH > array->h ? (int)font->atlasH : array->h;
+		int numLayers = layer < array->numLayers ? array->numLayers : array->numLayers * 2 + 1;
+		if(w > array->w || h > array->h || numLayers > array->numLayers)
+			_DNUI_resize_font_array(array, flags, w, h, numLayers);
+
+		return array->texture;
+	}
+
+	//otherwise the font gets its own texture:
+	//---------------------------------
+	GLuint tex;
+	glGenTextures(1, &tex);
+	glBindTexture(GL_TEXTURE_2D, tex);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	return tex;
+}
+
+static void _DNUI_upload_atlas(DNUIfont* font, const unsigned char* pixels)
+{
+	if(_DNUI_use_compressed_atlas(font->internal->flags))
+	{
+		unsigned char* blocks = malloc(_DNUI_get_compressed_atlas_size(font->atlasW, font->atlasH));
+		_DNUI_compress_atlas(pixels, font->atlasW, font->atlasH, 0, 0, font->atlasW, font->atlasH, blocks);
+		_DNUI_upload_atlas_data(font, blocks);
+		free(blocks);
+	}
+	else
+		_DNUI_upload_atlas_data(font, pixels);
+}
+
+static void _DNUI_upload_atlas_data(DNUIfont* font, const unsigned char* data)
+{
+	unsigned int flags = font->internal->flags;
+	int w = font->atlasW;
+	int h = font->atlasH;
+	bool compressed = _DNUI_use_compressed_atlas(flags);
+	GLsizei compressedSize = (GLsizei)_DNUI_get_compressed_atlas_size(w, h);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); //since the bitmaps generated by freetype have an alignment of 1 byte
+
+	//texture arrays grow to fit the atlas, which is uploaded into the top left of the font's layer:
+	//---------------------------------
+	if(flags & DNUI_FONT_TEXTURE_ARRAY)
+	{
+		_DNUIfontArray* array = _DNUI_get_font_array(flags);
+		if(w > array->w || h > array->h)
+			_DNUI_resize_font_array(array, flags, w > array->w ? w : array->w, h > array->h ? h : array->h, array->numLayers);
+
+		glBindTexture(GL_TEXTURE_2D_ARRAY, array->texture);
+		if(compressed)
+			glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, font->atlasLayer, (w + 3) & ~3, (h + 3) & ~3, 1, GL_COMPRESSED_RED_RGTC1, compressedSize, data);
+		else
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, font->atlasLayer, w, h, 1, _DNUI_get_atlas_format(flags), GL_UNSIGNED_BYTE, data);
+
+		return;
+	}
+
+	//otherwise the texture is reallocated at the atlas' size:
+	//---------------------------------
+	glBindTexture(GL_TEXTURE_2D, font->textureAtlas);
+	if(compressed)
+		glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RED_RGTC1, w, h, 0, compressedSize, data);
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, _DNUI_get_atlas_format(flags), w, h, 0, _DNUI_get_atlas_format(flags), GL_UNSIGNED_BYTE, data);
+}
+
+static void _DNUI_update_atlas(DNUIfont* font, int x, int y, int w, int h)
+{
+	_DNUIfontInternal* internal = font->internal;
+	bool inArray = (internal->flags & DNUI_FONT_TEXTURE_ARRAY) != 0;
+	GLenum target = inArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+	glBindTexture(target, font->textureAtlas);
+
+	if(_DNUI_use_compressed_atlas(internal->flags))
+	{
+		//compressed updates must cover whole blocks, so the blocks around the glyph are re-encoded along with any neighbours they overlap:
+		int textureW = inArray ? _DNUI_get_font_array(internal->flags)->w : (int)font->atlasW;
+		int textureH = inArray ? _DNUI_get_font_array(internal->flags)->h : (int)font->atlasH;
+		int blockX = x & ~3;
+		int blockY = y & ~3;
+		int blockW = ((x + w + 3) & ~3) < textureW ? ((x + w + 3) & ~3) - blockX : textureW - blockX;
+		int blockH = ((y + h + 3) & ~3) < textureH ? ((y + h + 3) & ~3) - blockY : textureH - blockY;
+
+		size_t size = _DNUI_get_compressed_atlas_size(blockW, blockH);
+		unsigned char* blocks = malloc(size);
+		_DNUI_compress_atlas(internal->atlasImage, font->atlasW, font->atlasH, blockX, blockY, blockW, blockH, blocks);
+
+		if(inArray)
+			glCompressedTexSubImage3D(target, 0, blockX, blockY, font->atlasLayer, blockW, blockH, 1, GL_COMPRESSED_RED_RGTC1, (GLsizei)size, blocks);
+		else
+			glCompressedTexSubImage2D(target, 0, blockX, blockY, blockW, blockH, GL_COMPRESSED_RED_RGTC1, (GLsizei)size, blocks);
+
+		free(blocks);
+		return;
+	}
+
+	const unsigned char* pixels = &internal->atlasImage[((size_t)y * font->atlasW + x) * _DNUI_get_atlas_channels(internal->flags)];
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, font->atlasW);
+	if(inArray)
+		glTexSubImage3D(target, 0, x, y, font->atlasLayer, w, h, 1, _DNUI_get_atlas_format(internal->flags), GL_UNSIGNED_BYTE, pixels);
+	else
+		glTexSubImage2D(target, 0, x, y, w, h, _DNUI_get_atlas_format(internal->flags), GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+static _DNUIfontArray* _DNUI_get_font_array(unsigned int flags)
+{
+	if(flags & DNUI_FONT_MSDF)
+		return &fontArrays[2];
+	else if(_DNUI_use_compressed_atlas(flags))
+		return &fontArrays[1];
+	else
+		return &fontArrays[0];
+}
+
+static void _DNUI_resize_font_array(_DNUIfontArray* array, unsigned int flags, int w, int h, int numLayers)
+{
+	_DNUI_flush_text(); //queued text has texture coordinates relative to the old size
+
+	//layers are kept a multiple of the block size, so compressed atlases can always be uploaded in whole blocks:
+	w = (w + 3) & ~3;
+	h = (h + 3) & ~3;
+
+	GLenum format = _DNUI_get_atlas_format(flags);
+	bool compressed = _DNUI_use_compressed_atlas(flags);
+
+	//copy the old layers into a temporary texture, so the array can be reallocated without its handle changing:
+	//---------------------------------
+	GLuint old = 0;
+	if(array->texture == 0)
+	{
+		glGenTextures(1, &array->texture);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, array->texture);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else if(array->numLayers > 0)
+	{
+		glGenTextures(1, &old);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, old);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0); //only complete textures can be copied
+		if(compressed)
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_COMPRESSED_RED_RGTC1, array->w, array->h, array->numLayers, 0, (GLsizei)(_DNUI_get_compressed_atlas_size(array->w, array->h) * array->numLayers), NULL);
+		else
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, array->w, array->h, array->numLayers, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+		glCopyImageSubData(array->texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, old, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, array->w, array->h, array->numLayers);
+	}
+
+	//reallocate and copy the old layers back:
+	//---------------------------------
+	glBindTexture(GL_TEXTURE_2D_ARRAY, array->texture);
+	if(compressed)
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_COMPRESSED_RED_RGTC1, w, h, numLayers, 0, (GLsizei)(_DNUI_get_compressed_atlas_size(w, h) * numLayers), NULL);
+	else
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, w, h, numLayers, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+	if(old != 0)
+	{
+		glCopyImageSubData(old, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, array->texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, array->w, array->h, array->numLayers);
+		glDeleteTextures(1, &old);
+	}
+
+	array->w = w;
+	array->h = h;
+	array->numLayers = numLayers;
+
+	//texture coordinates are relative to the layer size, so every font in the array needs new ones:
+	//---------------------------------
+	for(int i = 0; i < numCachedFonts; i++)
+	{
+		DNUIfont* font = fontCache[i];
+		if(!(font->internal->flags & DNUI_FONT_TEXTURE_ARRAY) || _DNUI_get_font_array(font->internal->flags) != array || font->internal->loading) //loading fonts get theirs once ready
+			continue;
+
+		_DNUI_mutex_lock(font->internal->mutex);
+		for(unsigned int j = 0; j < font->glyphCapacity; j++)
+			if(font->glyphs[j].loaded && font->glyphs[j].resident)
+				_DNUI_set_glyph_tex_coords(font, &font->glyphs[j]);
+		_DNUI_mutex_unlock(font->internal->mutex);
+	}
+}
+
+bool _DNUI_render_glyph(FT_Face face, FT_UInt glyphIndex, unsigned int flags, _DNUIrenderedGlyph* glyph)
+{
+	*glyph = (_DNUIrenderedGlyph){0};
+
+	//single-channel fields can be generated by dnui straight from the hinted outline, instead of converting a rasterized bitmap, which is much faster:
+	//---------------------------------
+	if((flags & DNUI_FONT_FAST_SDF) && !(flags & DNUI_FONT_MSDF))
+	{
+		if(!_DNUI_get_glyph_metrics(face, glyphIndex, flags, glyph))
+			return false;
+
+		//glyphs with only a bitmap go through freetype:
+		if(face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+		{
+			if(glyph->w > 0 && glyph->h > 0)
+			{
+				glyph->pitch = glyph->w;
+				glyph->pixels = malloc((size_t)glyph->w * glyph->h);
+				glyph->allocated = true;
+				_DNUI_generate_sdf(&face->glyph->outline, glyph->l, glyph->t, glyph->w, glyph->h, glyph->pixels);
+			}
+
+			return true;
+		}
+	}
+
+	//otherwise, single-channel fields come from freetype's sdf renderer. The glyph is rasterized when loading and the anti-aliased bitmap is converted,
+	//rendering the field straight from the outline (FT_LOAD_DEFAULT) avoids that but makes loading 2-3x slower:
+	//---------------------------------
+	if(!(flags & DNUI_FONT_MSDF))
+	{
+		if(FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER))
+			return false;
+
+		FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF); //fails for empty glyphs, such as space, which is fine. TODO: find a way to not render the text twice
+
+		FT_Bitmap* bitmap = &face->glyph->bitmap;
+		glyph->advance = face->glyph->advance.x / 64.0f;
+		glyph->w = bitmap->width;
+		glyph->h = bitmap->rows;
+		glyph->l = face->glyph->bitmap_left;
+		glyph->t = face->glyph->bitmap_top;
+		glyph->pitch = bitmap->pitch;
+		glyph->pixels = bitmap->buffer;
+
+		return true;
+	}
+
+	//multi-channel fields are generated from the unhinted outline, since they get drawn far from the size they were rendered at:
+	//---------------------------------
+	if(FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP))
+		return false;
+
+	glyph->advance = face->glyph->advance.x / 64.0f;
+	if(face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+		return true;
+
+	int w, h;
+	_DNUI_get_sdf_bounds(&face->glyph->outline, &glyph->l, &glyph->t, &w, &h);
+	if(w == 0 || h == 0)
+		return true;
+
+	glyph->w = w;
+	glyph->h = h;
+	glyph->pitch = w * 3;
+	glyph->pixels = malloc((size_t)w * h * 3);
+	glyph->allocated = true;
+	_DNUI_generate_msdf(&face->glyph->outline, glyph->l, glyph->t, w, h, glyph->pixels);
+
+	return true;
+}
+
+static bool _DNUI_get_glyph_metrics(FT_Face face, FT_UInt glyphIndex, unsigned int flags, _DNUIrenderedGlyph* glyph)
+{
+	//gets the same metrics as _DNUI_render_glyph() without rendering, leaves pixels NULL:
+	*glyph = (_DNUIrenderedGlyph){0};
+
+	//freetype presets the bitmap's size when loading, the sdf renderer pads it by DNUI_SDF_SPREAD on each side:
+	//---------------------------------
+	if(!(flags & DNUI_FONT_MSDF))
+	{
+		if(FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT))
+			return false;
+
+		FT_GlyphSlot slot = face->glyph;
+		glyph->advance = slot->advance.x / 64.0f;
+		glyph->l = slot->bitmap_left;
+		glyph->t = slot->bitmap_top;
+		if(slot->bitmap.width > 0 && slot->bitmap.rows > 0)
+		{
+			glyph->w = slot->bitmap.width + 2 * DNUI_SDF_SPREAD;
+			glyph->h = slot->bitmap.rows + 2 * DNUI_SDF_SPREAD;
+			glyph->l -= DNUI_SDF_SPREAD;
+			glyph->t += DNUI_SDF_SPREAD;
+		}
+
+		return true;
+	}
+
+	//multi-channel fields use the unhinted outline's bounds:
+	//---------------------------------
+	if(FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP))
+		return false;
+
+	glyph->advance = face->glyph->advance.x / 64.0f;
+	if(face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+		return true;
+
+	int w, h;
+	_DNUI_get_sdf_bounds(&face->glyph->outline, &glyph->l, &glyph->t, &w, &h);
+	if(w > 0 && h > 0)
+	{
+		glyph->w = w;
+		glyph->h = h;
+	}
+
+	return true;
+}
+
+static int _DNUI_get_atlas_channels(unsigned int flags)
+{
+	return (flags & DNUI_FONT_MSDF) ? 3 : 1;
+}
+
+static GLenum _DNUI_get_atlas_format(unsigned int flags)
+{
+	return (flags & DNUI_FONT_MSDF) ? GL_RGB : GL_RED;
+}
+
+static bool _DNUI_wants_compressed_atlas(unsigned int flags)
+{
+	return (flags & DNUI_FONT_COMPRESSED) && !(flags & DNUI_FONT_MSDF); //rgtc1 only has 1 channel
+}
+
+static bool _DNUI_use_compressed_atlas(unsigned int flags)
+{
+	return _DNUI_wants_compressed_atlas(flags) && GLAD_GL_VERSION_3_0; //rgtc is core since opengl 3.0
+}
+
+static size_t _DNUI_get_compressed_atlas_size(int w, int h)
+{
+	return (size_t)((w + 3) / 4) * ((h + 3) / 4) * 8;
+}
+
+static void _DNUI_compress_atlas(const unsigned char* image, int imageW, int imageH, int x, int y, int w, int h, unsigned char* blocks)
+{
+	//x and y must be multiples of 4, texels past the image's edges repeat the last row or column:
+	for(int blockY = y; blockY < y + h; blockY += 4)
+		for(int blockX = x; blockX < x + w; blockX += 4)
+		{
+			unsigned char texels[16];
+			unsigned char lo = 255, hi = 0;
+			for(int i = 0; i < 16; i++)
+			{
+				int texelX = blockX + i % 4 < imageW ? blockX + i % 4 : imageW - 1;
+				int texelY = blockY + i / 4 < imageH ? blockY + i / 4 : imageH - 1;
+				texels[i] = image[(size_t)texelY * imageW + texelX];
+				lo = texels[i] < lo ? texels[i] : lo;
+				hi = texels[i] > hi ? texels[i] : hi;
+			}
+
+			//use the 8 value mode, where index 0 is hi, 1 is lo, and 2-7 step evenly from hi to lo:
+			uint64_t indices = 0;
+			if(hi > lo)
+				for(int i = 0; i < 16; i++)
+				{
+					int step = ((hi - texels[i]) * 7 + (hi - lo) / 2) / (hi - lo);
+					uint64_t index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+					indices |= index << (3 * i);
+				}
+
+			blocks[0] = hi;
+			blocks[1] = lo;
+			for(int i = 0; i < 6; i++)
+				blocks[2 + i] = (unsigned char)(indices >> (8 * i));
+
+			blocks += 8;
+		}
+}
+
+static void _DNUI_decompress_atlas(const unsigned char* blocks, int w, int h, unsigned char* image)
+{
+	for(int blockY = 0; blockY < h; blockY += 4)
+		for(int blockX = 0; blockX < w; blockX += 4)
+		{
+			int r0 = blocks[0];
+			int r1 = blocks[1];
+			unsigned char palette[8] = {(unsigned char)r0, (unsigned char)r1, 0, 0, 0, 0, 0, 255};
+			if(r0 > r1)
+				for(int i = 2; i < 8; i++)
+					palette[i] = (unsigned char)(((8 - i) * r0 + (i - 1) * r1 + 3) / 7);
+			else
+				for(int i = 2; i < 6; i++)
+					palette[i] = (unsigned char)(((6 - i) * r0 + (i - 1) * r1 + 2) / 5);
+
+			uint64_t indices = 0;
+			for(int i = 0; i < 6; i++)
+				indices |= (uint64_t)blocks[2 + i] << (8 * i);
+
+			for(int i = 0; i < 16; i++)
+				if(blockX + i % 4 < w && blockY + i / 4 < h)
+					image[(size_t)(blockY + i / 4) * w + blockX + i % 4] = palette[(indices >> (3 * i)) & 7];
+
+			blocks += 8;
+		}
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static DNUIglyph* _DNUI_find_glyph(DNUIfont* font, uint32_t codepoint)
+{
+	uint32_t hash = codepoint * 2654435761u;
+	hash ^= hash >> 16;
+
+	unsigned int mask = font->glyphCapacity - 1;
+	unsigned int i = hash & mask;
+	while(font->glyphs[i].loaded && font->glyphs[i].codepoint != codepoint)
+		i = (i + 1) & mask;
+
+	return &font->glyphs[i];
+}
+
+static void _DNUI_grow_glyph_table(DNUIfont* font)
+{
+	DNUIglyph* oldGlyphs = font->glyphs;
+	unsigned int oldCapacity = font->glyphCapacity;
+
+	font->glyphCapacity *= 2;
+	font->glyphs = calloc(font->glyphCapacity, sizeof(DNUIglyph));
+
+	for(unsigned int i = 0; i < oldCapacity; i++)
+		if(oldGlyphs[i].loaded)
+			*_DNUI_find_glyph(font, oldGlyphs[i].codepoint) = oldGlyphs[i];
+
+	free(oldGlyphs);
+}
+
+static void _DNUI_drop_missing_glyphs(DNUIfont* font)
+{
+	//rebuilds the glyph table without glyphs none of the font's faces have. Their bitmaps stay in the atlas until it's next repacked:
+	_DNUIfontInternal* internal = font->internal;
+	DNUIglyph* oldGlyphs = font->glyphs;
+	font->glyphs = calloc(font->glyphCapacity, sizeof(DNUIglyph));
+	font->numGlyphs = 0;
+
+	for(unsigned int i = 0; i < font->glyphCapacity; i++)
+	{
+		if(!oldGlyphs[i].loaded)
+			continue;
+
+		bool missing = true;
+		for(int j = 0; j < internal->numFaces && missing; j++)
+			missing = FT_Get_Char_Index(internal->faces[j], oldGlyphs[i].codepoint) == 0;
+
+		if(!missing)
+		{
+			*_DNUI_find_glyph(font, oldGlyphs[i].codepoint) = oldGlyphs[i];
+			font->numGlyphs++;
+		}
+	}
+
+	free(oldGlyphs);
+
+	//the dense ascii metrics are filled again the next time the font is measured:
+	internal->asciiMetricsLoaded = false;
+}
+
+static DNUIglyph* _DNUI_get_glyph(DNUIfont* font, uint32_t codepoint, bool needBitmap)
+{
+	DNUIglyph* glyph = _DNUI_find_glyph(font, codepoint);
+	if(glyph->loaded && (glyph->resident || !needBitmap))
+		return glyph;
+
+	//keep the table at most half full:
+	if(!glyph->loaded && (font->numGlyphs + 1) * 2 > font->glyphCapacity)
+	{
+		_DNUI_grow_glyph_table(font);
+		glyph = _DNUI_find_glyph(font, codepoint);
+	}
+
+	//baked fonts have no face to render missing glyphs with:
+	_DNUIfontInternal* internal = font->internal;
+	if(internal->numFaces == 0)
+	{
+		*glyph = (DNUIglyph){0};
+		glyph->codepoint = codepoint;
+		glyph->loaded = true;
+		glyph->resident = true;
+		font->numGlyphs++;
+
+		return glyph;
+	}
+
+	//render with the first face that has the glyph, falling back to the primary face's missing glyph:
+	//---------------------------------
+	FT_Face face = internal->faces[0];
+	FT_UInt glyphIndex = FT_Get_Char_Index(face, codepoint);
+	for(int i = 1; i < internal->numFaces && glyphIndex == 0; i++)
+	{
+		FT_UInt fallbackIndex = FT_Get_Char_Index(internal->faces[i], codepoint);
+		if(fallbackIndex != 0)
+		{
+			face = internal->faces[i];
+			glyphIndex = fallbackIndex;
+		}
+	}
+
+	//measuring only needs the glyph's metrics, its bitmap is rendered the first time it's drawn:
+	//---------------------------------
+	if(!needBitmap)
+	{
+		_DNUIrenderedGlyph metrics;
+		if(!_DNUI_get_glyph_metrics(face, glyphIndex, internal->flags, &metrics))
+		{
+			printf("DNUI ERROR - FAILED TO LOAD CHARACTER U+%04X\n", codepoint);
+			metrics = (_DNUIrenderedGlyph){0};
+		}
+
+		glyph->codepoint = codepoint;
+		glyph->loaded = true;
+		glyph->resident = metrics.w == 0 || metrics.h == 0; //nothing to render
+		glyph->advance = metrics.advance;
+		glyph->bmpW = metrics.w;
+		glyph->bmpH = metrics.h;
+		glyph->bmpL = metrics.l;
+		glyph->bmpT = metrics.t;
+		font->numGlyphs++;
+
+		return glyph;
+	}
+
+	//render:
+	//---------------------------------
+	_DNUIrenderedGlyph bitmap;
+	bool rendered = _DNUI_render_glyph(face, glyphIndex, internal->flags, &bitmap);
+	if(!rendered)
+		printf("DNUI ERROR - FAILED TO LOAD CHARACTER U+%04X\n", codepoint);
+
+	//set data:
+	//---------------------------------
+	if(!glyph->loaded)
+	{
+		glyph->codepoint = codepoint;
+		glyph->loaded = true;
+		font->numGlyphs++;
+
+		if(rendered)
+		{
+			glyph->advance = bitmap.advance;
+			glyph->bmpW = bitmap.w;
+			glyph->bmpH = bitmap.h;
+			glyph->bmpL = bitmap.l;
+			glyph->bmpT = bitmap.t;
+		}
+	}
+
+	glyph->lastUsed = font->useStamp;
+
+	if(!rendered || bitmap.w == 0 || bitmap.h == 0)
+		glyph->resident = true;
+	else
+		_DNUI_add_to_atlas(font, glyph, bitmap.pixels, bitmap.pitch);
+
+	if(rendered && bitmap.allocated)
+		free(bitmap.pixels);
+
+	return glyph;
+}
+
+static bool _DNUI_add_to_atlas(DNUIfont* font, DNUIglyph* glyph, const unsigned char* pixels, int pitch)
+{
+	_DNUIfontInternal* internal = font->internal;
+	int channels = _DNUI_get_atlas_channels(internal->flags);
+	int w = glyph->bmpW;
+	int h = glyph->bmpH;
+
+	while(true)
+	{
+		int x, y;
+		if(_DNUI_skyline_insert(&internal->skyline, w + DNUI_ATLAS_PADDING, h + DNUI_ATLAS_PADDING, &x, &y))
+		{
+			for(int row = 0; row < h; row++)
+				memcpy(&internal->atlasImage[((size_t)(y + row) * font->atlasW + x) * channels], &pixels[row * pitch], w * channels);
+
+			glyph->atlasX = x;
+			glyph->atlasY = y;
+			glyph->resident = true;
+			_DNUI_set_glyph_tex_coords(font, glyph);
+
+			_DNUI_update_atlas(font, x, y, w, h);
+
+			return true;
+		}
+
+		//grow the atlas while it is under the size limit, keeping it near-square, then start evicting glyphs:
+		//---------------------------------
+		if(font->atlasH < font->atlasW && font->atlasH * 2 <= (unsigned int)maxFontAtlasSize)
+			_DNUI_repack_atlas(font, font->atlasW, font->atlasH * 2);
+		else if(font->atlasW * 2 <= (unsigned int)maxFontAtlasSize)
+			_DNUI_repack_atlas(font, font->atlasW * 2, font->atlasH);
+		else if(!_DNUI_evict_glyphs(font))
+		{
+			printf("DNUI ERROR - NO SPACE IN FONT ATLAS FOR CHARACTER U+%04X\n", glyph->codepoint);
+			return false;
+		}
+	}
+}
+
+static int _DNUI_compare_glyph_use(const void* a, const void* b)
+{
+	unsigned int useA = (*(DNUIglyph* const*)a)->lastUsed;
+	unsigned int useB = (*(DNUIglyph* const*)b)->lastUsed;
+	return (useA > useB) - (useA < useB);
+}
+
+static bool _DNUI_evict_glyphs(DNUIfont* font)
+{
+	//glyphs used in the line currently being drawn are never evicted:
+	//---------------------------------
+	DNUIglyph** candidates = malloc(font->numGlyphs * sizeof(DNUIglyph*));
+	int numCandidates = 0;
+
+	for(unsigned int i = 0; i < font->glyphCapacity; i++)
+	{
+		DNUIglyph* glyph = &font->glyphs[i];
+		if(glyph->loaded && glyph->resident && glyph->bmpW > 0 && glyph->bmpH > 0 && glyph->lastUsed != font->useStamp)
+			candidates[numCandidates++] = glyph;
+	}
+
+	if(numCandidates == 0)
+	{
+		free(candidates);
+		return false;
+	}
+
+	//evict the least recently used quarter, then compact what's left:
+	//---------------------------------
+	qsort(candidates, numCandidates, sizeof(DNUIglyph*), _DNUI_compare_glyph_use);
+
+	int numEvicted = (numCandidates + 3) / 4;
+	for(int i = 0; i < numEvicted; i++)
+		candidates[i]->resident = false;
+
+	free(candidates);
+
+	_DNUI_repack_atlas(font, font->atlasW, font->atlasH);
+	return true;
+}
+
+static void _DNUI_repack_atlas(DNUIfont* font, int w, int h)
+{
+	_DNUI_flush_text(); //queued text may use glyphs that are about to move
+	_DNUIfontInternal* internal = font->internal;
+
+	//collect resident glyphs, tallest first:
+	//---------------------------------
+	_DNUIatlasRect* rects = malloc(font->numGlyphs * sizeof(_DNUIatlasRect));
+	int numRects = 0;
+
+	for(unsigned int i = 0; i < font->glyphCapacity; i++)
+	{
+		DNUIglyph* glyph = &font->glyphs[i];
+		if(glyph->loaded && glyph->resident && glyph->bmpW > 0 && glyph->bmpH > 0)
+			rects[numRects++] = (_DNUIatlasRect){i, (int)glyph->bmpW, (int)glyph->bmpH, 0, 0};
+	}
+
+	qsort(rects, numRects, sizeof(_DNUIatlasRect), _DNUI_compare_atlas_rects);
+
+	//move bitmaps into a new image:
+	//---------------------------------
+	_DNUIskyline skyline;
+	_DNUI_skyline_init(&skyline, w, h);
+	int channels = _DNUI_get_atlas_channels(internal->flags);
+	unsigned char* atlas = calloc((size_t)w * h, channels);
+
+	for(int i = 0; i < numRects; i++)
+	{
+		DNUIglyph* glyph = &font->glyphs[rects[i].glyph];
+
+		int x, y;
+		if(!_DNUI_skyline_insert(&skyline, rects[i].w + DNUI_ATLAS_PADDING, rects[i].h + DNUI_ATLAS_PADDING, &x, &y))
+		{
+			glyph->resident = false;
+			continue;
+		}
+
+		for(int row = 0; row < rects[i].h; row++)
+			memcpy(&atlas[((size_t)(y + row) * w + x) * channels], &internal->atlasImage[((size_t)(glyph->atlasY + row) * font->atlasW + glyph->atlasX) * channels], rects[i].w * channels);
+
+		glyph->atlasX = x;
+		glyph->atlasY = y;
+	}
+
+	free(rects);
+	_DNUI_skyline_free(&internal->skyline);
+	free(internal->atlasImage);
+
+	internal->skyline = skyline;
+	internal->atlasImage = atlas;
+	font->atlasW = w;
+	font->atlasH = h;
+
+	for(unsigned int i = 0; i < font->glyphCapacity; i++)
+		if(font->glyphs[i].loaded && font->glyphs[i].resident)
+			_DNUI_set_glyph_tex_coords(font, &font->glyphs[i]);
+
+	//upload:
+	//---------------------------------
+	_DNUI_upload_atlas(font, atlas);
+}
+
+static void _DNUI_set_glyph_tex_coords(DNUIfont* font, DNUIglyph* glyph)
 {
-	DNUI_draw_string(text, font, pos, scale, wrap, align, color, 0.5f, 0.05f, (DNvec4){0.0f, 0.0f, 0.0f, 0.0f}, 1.0f, 0.05f);
+	//fonts in a texture array only cover the top left of their layer:
+	float textureW = font->atlasW;
+	float textureH = font->atlasH;
+	if(font->internal->flags & DNUI_FONT_TEXTURE_ARRAY)
+	{
+		textureW = _DNUI_get_font_array(font->internal->flags)->w;
+		textureH = _DNUI_get_font_array(font->internal->flags)->h;
+	}
+
+	glyph->texL = (float)glyph->atlasX / textureW;
+	glyph->texT = (float)glyph->atlasY / textureH;
+	glyph->texR = (float)(glyph->atlasX + glyph->bmpW) / textureW;
+	glyph->texB = (float)(glyph->atlasY + glyph->bmpH) / textureH;
 }
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 
-void DNUI_draw_rect(int textureHandle, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness)
+static void _DNUI_load_kerning(DNUIfont* font)
 {
-	DNmat3 model = DN_mat3_translate(center);
-	model = DN_mat3_mult(model, DN_mat3_rotate(angle));
-	model = DN_mat3_mult(model, DN_mat3_scale((DNvec2){size.x * 0.5f, size.y * 0.5f}));
+	_DNUIfontInternal* internal = font->internal;
+	FT_Face face = internal->faces[0];
+	if(!FT_HAS_KERNING(face))
+		return;
 
-	model = DN_mat3_mult(projectionMat, model);
+	//fill the dense table up front, so common pairs never need freetype:
+	//---------------------------------
+	FT_UInt indices[DNUI_KERNING_TABLE_SIZE];
+	for(int i = 0; i < DNUI_KERNING_TABLE_SIZE; i++)
+		indices[i] = FT_Get_Char_Index(face, i);
 
-	glUseProgram(rectProgram);
+	internal->asciiKerning = calloc(DNUI_KERNING_TABLE_SIZE * DNUI_KERNING_TABLE_SIZE, sizeof(float));
+	for(int l = 0; l < DNUI_KERNING_TABLE_SIZE; l++)
+	for(int r = 0; r < DNUI_KERNING_TABLE_SIZE; r++)
+	{
+		FT_Vector kerning;
+		if(indices[l] != 0 && indices[r] != 0 && !FT_Get_Kerning(face, indices[l], indices[r], FT_KERNING_UNFITTED, &kerning))
+			internal->asciiKerning[l * DNUI_KERNING_TABLE_SIZE + r] = kerning.x / 64.0f;
+	}
+}
 
-	glUniformMatrix3fv(glGetUniformLocation(rectProgram, "modelProjection"), 1, GL_FALSE, (GLfloat*)&model);
-	glUniform4fv(glGetUniformLocation(rectProgram, "color"), 1, (GLfloat*)&color);
-	glUniform2fv(glGetUniformLocation(rectProgram, "size"), 1, (GLfloat*)&size);
-	glUniform1f(glGetUniformLocation(rectProgram, "cornerRad"), cornerRad);
+static float _DNUI_get_kerning(DNUIfont* font, uint32_t left, uint32_t right)
+{
+	_DNUIfontInternal* internal = font->internal;
+	if(!internal->asciiKerning)
+		return 0.0f;
 
-	glUniform4fv(glGetUniformLocation(rectProgram, "outlineColor"), 1, (GLfloat*)&outlineColor);
-	glUniform1f(glGetUniformLocation(rectProgram, "outlineThickness"), outlineThickness);
+	if(left < DNUI_KERNING_TABLE_SIZE && right < DNUI_KERNING_TABLE_SIZE)
+		return internal->asciiKerning[left * DNUI_KERNING_TABLE_SIZE + right];
 
-	glUniform1ui(glGetUniformLocation(rectProgram, "useTex"), textureHandle >= 0);
-	glUniform1i(glGetUniformLocation(rectProgram, "tex"), 0);
+	_DNUIkerningPair* pair = _DNUI_find_kerning_pair(font, left, right);
+	if(pair && pair->used)
+		return pair->x;
 
-	if(textureHandle >= 0)
+	//baked fonts store every pair they have, otherwise ask the primary face once and cache the result, even if it's 0:
+	//---------------------------------
+	if(internal->numFaces == 0)
+		return 0.0f;
+
+	float x = 0.0f;
+	FT_Face face = internal->faces[0];
+	FT_UInt leftIndex = FT_Get_Char_Index(face, left);
+	FT_UInt rightIndex = FT_Get_Char_Index(face, right);
+
+	FT_Vector kerning;
+	if(leftIndex != 0 && rightIndex != 0 && !FT_Get_Kerning(face, leftIndex, rightIndex, FT_KERNING_UNFITTED, &kerning))
+		x = kerning.x / 64.0f;
+
+	_DNUI_add_kerning_pair(font, left, right, x);
+	return x;
+}
+
+static _DNUIkerningPair* _DNUI_find_kerning_pair(DNUIfont* font, uint32_t left, uint32_t right)
+{
+	_DNUIfontInternal* internal = font->internal;
+	if(internal->kerningCapacity == 0)
+		return NULL;
+
+	uint32_t hash = left * 2654435761u ^ right * 2246822519u;
+	hash ^= hash >> 16;
+
+	unsigned int mask = internal->kerningCapacity - 1;
+	unsigned int i = hash & mask;
+	while(internal->kerningPairs[i].used && (internal->kerningPairs[i].left != left || internal->kerningPairs[i].right != right))
+		i = (i + 1) & mask;
+
+	return &internal->kerningPairs[i];
+}
+
+static void _DNUI_add_kerning_pair(DNUIfont* font, uint32_t left, uint32_t right, float x)
+{
+	_DNUIfontInternal* internal = font->internal;
+	if(left < DNUI_KERNING_TABLE_SIZE && right < DNUI_KERNING_TABLE_SIZE)
 	{
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureHandle);
+		internal->asciiKerning[left * DNUI_KERNING_TABLE_SIZE + right] = x;
+		return;
 	}
 
-	glBindVertexArray(rectArray);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
+	//keep the table at most half full:
+	//---------------------------------
+	if((internal->numKerningPairs + 1) * 2 > internal->kerningCapacity)
+	{
+		_DNUIkerningPair* oldPairs = internal->kerningPairs;
+		unsigned int oldCapacity = internal->kerningCapacity;
+
+		internal->kerningCapacity = oldCapacity > 0 ? oldCapacity * 2 : DNUI_MIN_GLYPH_TABLE_SIZE;
+		internal->kerningPairs = calloc(internal->kerningCapacity, sizeof(_DNUIkerningPair));
+
+		for(unsigned int i = 0; i < oldCapacity; i++)
+			if(oldPairs[i].used)
+				*_DNUI_find_kerning_pair(font, oldPairs[i].left, oldPairs[i].right) = oldPairs[i];
+
+		free(oldPairs);
+	}
+
+	_DNUIkerningPair* pair = _DNUI_find_kerning_pair(font, left, right);
+	if(!pair->used)
+		internal->numKerningPairs++;
+
+	*pair = (_DNUIkerningPair){left, right, x, true};
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static void _DNUI_load_ascii_metrics(DNUIfont* font)
+{
+	_DNUIfontInternal* internal = font->internal;
+	for(uint32_t codepoint = 0; codepoint < DNUI_KERNING_TABLE_SIZE; codepoint++)
+	{
+		DNUIglyph* glyph = _DNUI_get_glyph(font, codepoint, false);
+		internal->asciiAdvances[codepoint] = glyph->advance;
+		internal->asciiWidths[codepoint] = glyph->bmpW;
+		internal->asciiBearings[codepoint] = glyph->bmpL;
+	}
+
+	internal->asciiMetricsLoaded = true;
+}
+
+static float _DNUI_measure_ascii(DNUIfont* font, const char* text, int len, uint32_t prevCodepoint, float w, bool last, float scale, DNvec2* positions)
+{
+	//measures a run of ascii characters, returning the pen position after them, or the right edge of the last glyph if the run ends the line.
+	//fills positions with the left edge and advance of each glyph, scaled, if not NULL. Metrics are multiples of 1/64 pixels, so summing them in any order gives the same result
+	_DNUIfontInternal* internal = font->internal;
+	if(!internal->asciiMetricsLoaded)
+		_DNUI_load_ascii_metrics(font);
+
+	const unsigned char* chars = (const unsigned char*)text;
+	const float* kerning = internal->asciiKerning;
+
+	float steps[DNUI_MEASURE_BLOCK_SIZE];    //how far each glyph moves the pen: its kerning with the previous glyph plus its advance
+	float advances[DNUI_MEASURE_BLOCK_SIZE];
+	for(int start = 0; start < len; start += DNUI_MEASURE_BLOCK_SIZE)
+	{
+		const unsigned char* block = &chars[start];
+		int n = len - start < DNUI_MEASURE_BLOCK_SIZE ? len - start : DNUI_MEASURE_BLOCK_SIZE;
+
+		//gather, the first glyph may be kerned with a codepoint outside the table:
+		//---------------------------------
+		int i = 0;
+		if(start == 0)
+		{
+			advances[0] = internal->asciiAdvances[block[0]];
+			steps[0] = _DNUI_get_kerning(font, prevCodepoint, block[0]) + advances[0];
+			i = 1;
+		}
+
+	#if defined(DNUI_MEASURE_AVX2)
+		for(; i + 8 <= n; i += 8)
+		{
+			__m256i codepoints = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&block[i]));
+			__m256 advance = _mm256_i32gather_ps(internal->asciiAdvances, codepoints, sizeof(float));
+			_mm256_storeu_ps(&advances[i], advance);
+
+			if(kerning)
+			{
+				__m256i prevCodepoints = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&block[i - 1]));
+				__m256i pairs = _mm256_add_epi32(_mm256_slli_epi32(prevCodepoints, 7), codepoints); //[left][right], DNUI_KERNING_TABLE_SIZE is 1 << 7
+				advance = _mm256_add_ps(_mm256_i32gather_ps(kerning, pairs, sizeof(float)), advance);
+			}
+
+			_mm256_storeu_ps(&steps[i], advance);
+		}
+	#endif
+
+		for(; i < n; i++)
+		{
+			advances[i] = internal->asciiAdvances[block[i]];
+			steps[i] = kerning ? kerning[block[i - 1] * DNUI_KERNING_TABLE_SIZE + block[i]] + advances[i] : advances[i];
+		}
+
+		//prefix sum, giving the right edge of each glyph's advance:
+		//---------------------------------
+		i = 0;
+
+	#if defined(DNUI_MEASURE_SSE2)
+		__m128 pen = _mm_set1_ps(w);
+		__m128 scaleVec = _mm_set1_ps(scale);
+		for(; i + 4 <= n; i += 4)
+		{
+			__m128 sum = _mm_loadu_ps(&steps[i]);
+			sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 4)));
+			sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 8)));
+
+			__m128 right = _mm_add_ps(sum, pen);
+			pen = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 3, 3, 3));
+
+			if(positions)
+			{
+				__m128 left = _mm_mul_ps(_mm_sub_ps(right, _mm_loadu_ps(&advances[i])), scaleVec);
+				right = _mm_mul_ps(right, scaleVec);
+				_mm_storeu_ps(&positions[start + i].x, _mm_unpacklo_ps(left, right));
+				_mm_storeu_ps(&positions[start + i + 2].x, _mm_unpackhi_ps(left, right));
+			}
+		}
+
+		w = _mm_cvtss_f32(pen);
+	#endif
+
+		for(; i < n; i++)
+		{
+			w += steps[i];
+			if(positions)
+				positions[start + i] = (DNvec2){(w - advances[i]) * scale, w * scale};
+		}
+	}
+
+	//the last glyph of a line ends at its bitmap's right edge instead:
+	if(last)
+	{
+		unsigned char c = chars[len - 1];
+		w += internal->asciiBearings[c] + internal->asciiWidths[c] - internal->asciiAdvances[c];
+	}
+
+	return w;
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static int _DNUI_compare_atlas_rects(const void* a, const void* b)
+{
+	return ((const _DNUIatlasRect*)b)->h - ((const _DNUIatlasRect*)a)->h;
+}
+
+static bool _DNUI_pack_atlas(_DNUIatlasRect* rects, int numRects, int w, int* h, _DNUIskyline* skyline)
+{
+	//tallest first, so each row of the skyline stays roughly level, the skyline is only kept if every rect fits:
+	qsort(rects, numRects, sizeof(_DNUIatlasRect), _DNUI_compare_atlas_rects);
+
+	_DNUI_skyline_init(skyline, w, w);
+
+	bool fit = true;
+	for(int i = 0; i < numRects && fit; i++)
+		fit = _DNUI_skyline_insert(skyline, rects[i].w + DNUI_ATLAS_PADDING, rects[i].h + DNUI_ATLAS_PADDING, &rects[i].x, &rects[i].y);
+
+	int usedH = 0;
+	for(int i = 0; i < skyline->numNodes; i++)
+		usedH = skyline->nodes[i].y > usedH ? skyline->nodes[i].y : usedH;
+
+	if(!fit)
+		_DNUI_skyline_free(skyline);
+
+	*h = 1;
+	while(*h < usedH)
+		*h *= 2;
+
+	return fit;
+}
+
+static void _DNUI_skyline_init(_DNUIskyline* skyline, int w, int h)
+{
+	skyline->w = w;
+	skyline->h = h;
+	skyline->numNodes = 1;
+	skyline->maxNodes = 16;
+	skyline->nodes = malloc(skyline->maxNodes * sizeof(_DNUIskylineNode));
+	skyline->nodes[0] = (_DNUIskylineNode){0, 0, w};
+}
+
+static void _DNUI_skyline_free(_DNUIskyline* skyline)
+{
+	free(skyline->nodes);
+}
+
+static bool _DNUI_skyline_insert(_DNUIskyline* skyline, int w, int h, int* x, int* y)
+{
+	_DNUIskylineNode* nodes = skyline->nodes;
+
+	//find the lowest position the rect fits at, preferring narrower gaps on ties:
+	//---------------------------------
+	int bestNode = -1;
+	int bestY = skyline->h;
+	int bestW = skyline->w;
+
+	for(int i = 0; i < skyline->numNodes; i++)
+	{
+		if(nodes[i].x + w > skyline->w)
+			break;
+
+		//the rect rests on the highest node it spans:
+		int top = 0;
+		for(int j = i, remaining = w; remaining > 0; j++)
+		{
+			top = nodes[j].y > top ? nodes[j].y : top;
+			remaining -= nodes[j].w;
+		}
+
+		if(top + h > skyline->h)
+			continue;
+
+		if(top < bestY || (top == bestY && nodes[i].w < bestW))
+		{
+			bestNode = i;
+			bestY = top;
+			bestW = nodes[i].w;
+		}
+	}
+
+	if(bestNode < 0)
+		return false;
+
+	*x = nodes[bestNode].x;
+	*y = bestY;
+
+	//add a node for the rect's top edge:
+	//---------------------------------
+	if(skyline->numNodes >= skyline->maxNodes)
+	{
+		skyline->maxNodes *= 2;
+		skyline->nodes = realloc(skyline->nodes, skyline->maxNodes * sizeof(_DNUIskylineNode));
+		nodes = skyline->nodes;
+	}
+
+	memmove(&nodes[bestNode + 1], &nodes[bestNode], (skyline->numNodes - bestNode) * sizeof(_DNUIskylineNode));
+	nodes[bestNode] = (_DNUIskylineNode){*x, bestY + h, w};
+	skyline->numNodes++;
+
+	//shrink or remove the nodes now covered by the rect:
+	//---------------------------------
+	int end = *x + w;
+	int i = bestNode + 1;
+	while(i < skyline->numNodes && nodes[i].x < end)
+	{
+		int overlap = end - nodes[i].x;
+		if(overlap < nodes[i].w)
+		{
+			nodes[i].x += overlap;
+			nodes[i].w -= overlap;
+			break;
+		}
+
+		memmove(&nodes[i], &nodes[i + 1], (skyline->numNodes - i - 1) * sizeof(_DNUIskylineNode));
+		skyline->numNodes--;
+	}
+
+	//merge neighboring nodes at the same height:
+	//---------------------------------
+	i = 0;
+	while(i < skyline->numNodes - 1)
+	{
+		if(nodes[i].y == nodes[i + 1].y)
+		{
+			nodes[i].w += nodes[i + 1].w;
+			memmove(&nodes[i + 1], &nodes[i + 2], (skyline->numNodes - i - 2) * sizeof(_DNUIskylineNode));
+			skyline->numNodes--;
+		}
+		else
+			i++;
+	}
+
+	return true;
 }
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 
-static bool _DNUI_load_into_buffer(const char* path, char** buffer)
+static _DNUIfontFile* _DNUI_open_font_file(const char* path)
+{
+	if(!fontFileMutex)
+		fontFileMutex = _DNUI_mutex_create();
+
+	_DNUI_mutex_lock(fontFileMutex);
+
+	//reuse the mapping if another face already opened the file:
+	//---------------------------------
+	for(int i = 0; i < numFontFiles; i++)
+	{
+		if(strcmp(fontFiles[i]->path, path) == 0)
+		{
+			_DNUIfontFile* file = fontFiles[i];
+			file->refCount++;
+
+			_DNUI_mutex_unlock(fontFileMutex);
+			return file;
+		}
+	}
+
+	//map the file:
+	//---------------------------------
+	const void* data;
+	size_t size;
+	_DNUIfileMapping* mapping = _DNUI_map_file(path, &data, &size);
+	if(!mapping)
+	{
+		printf("DNUI ERROR - COULD NOT OPEN FILE %s\n", path);
+		_DNUI_mutex_unlock(fontFileMutex);
+		return NULL;
+	}
+
+	_DNUIfontFile* file = malloc(sizeof(_DNUIfontFile));
+	file->path = malloc(strlen(path) + 1);
+	strcpy(file->path, path);
+	file->mapping = mapping;
+	file->data = data;
+	file->size = size;
+	file->refCount = 1;
+
+	if(numFontFiles >= maxFontFiles)
+	{
+		maxFontFiles = maxFontFiles > 0 ? maxFontFiles * 2 : 8;
+		fontFiles = realloc(fontFiles, maxFontFiles * sizeof(_DNUIfontFile*));
+	}
+
+	fontFiles[numFontFiles++] = file;
+
+	_DNUI_mutex_unlock(fontFileMutex);
+	return file;
+}
+
+static void _DNUI_close_font_file(_DNUIfontFile* file)
+{
+	_DNUI_mutex_lock(fontFileMutex);
+	if(--file->refCount > 0)
+	{
+		_DNUI_mutex_unlock(fontFileMutex);
+		return;
+	}
+
+	for(int i = 0; i < numFontFiles; i++)
+	{
+		if(fontFiles[i] == file)
+		{
+			fontFiles[i] = fontFiles[--numFontFiles];
+			break;
+		}
+	}
+
+	_DNUI_mutex_unlock(fontFileMutex);
+
+	_DNUI_unmap_file(file->mapping);
+	free(file->path);
+	free(file);
+}
+
+static bool _DNUI_load_into_buffer(const char* path, char** buffer, size_t* size)
 {
 	*buffer = 0;
 	long length;
@@ -490,7 +4107,11 @@ static bool _DNUI_load_into_buffer(const char* path, char** buffer)
 		if(*buffer)
 		{
 			if(fread(*buffer, length, 1, file) == 1)
+			{
 				result = true;
+				if(size)
+					*size = length;
+			}
 			else
 			{
 				printf("DNUI ERROR - COULD NOT READ FROM FILE %s\n", path);
@@ -515,11 +4136,11 @@ bool _DNUI_load_shader_program(const char* vertPath, const char* fragPath, GLuin
 {
 	//load from files:
 	char* vertexSource = 0;
-	if(!_DNUI_load_into_buffer(vertPath, &vertexSource))
+	if(!_DNUI_load_into_buffer(vertPath, &vertexSource, NULL))
 		return false;
 
 	char* fragmentSource = 0;
-	if(!_DNUI_load_into_buffer(fragPath, &fragmentSource))
+	if(!_DNUI_load_into_buffer(fragPath, &fragmentSource, NULL))
 		return false;
 
 	unsigned int vertex, fragment;
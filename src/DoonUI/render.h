@@ -8,6 +8,8 @@ extern "C"
 
 #include "QuickMath/quickmath.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 //INITIALIZATION:
@@ -18,7 +20,7 @@ extern "C"
  * @returns true on success, false on failure 
  */
 bool DNUI_init(unsigned int windowW, unsigned int windowH);
-/* De-initializes the DoonUI library, must be called to avoid memory leaks
+/* De-initializes the DoonUI library, must be called to avoid memory leaks. Also call it if only DNUI_load_font_metrics() was used, without DNUI_init()
  */
 void DNUI_close();
 
@@ -31,46 +33,179 @@ DNvec2 DNUI_get_window_size();
  */
 void DNUI_set_window_size(unsigned int w, unsigned int h);
 
+/* Call at the start of every frame, before anything is rendered. Invalidates per-frame data, such as the blurred framebuffer used by DNUI_draw_rect_blurred(),
+ * and uploads the atlases of fonts loaded with DNUI_load_font_async() that finished loading
+ */
+void DNUI_begin_frame();
+
+/* Sets whether DNUI outputs premultiplied alpha colors, disabled by default. Colors passed to DNUI are still given in straight alpha,
+ * but textures are assumed to be premultiplied, so UI that was rendered into a texture composites correctly when drawn again.
+ * When enabled, blending should be set up with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+ * @param enable whether to output premultiplied alpha
+ */
+void DNUI_set_premultiplied_alpha(bool enable);
+
 //--------------------------------------------------------------------------------------------------------------------------------//
 //TEXT RENDERING:
 
-//represents a font for text rendering
+#define DNUI_MAX_FALLBACK_FONTS 8 //the maximum number of fallback fonts a font can have
+
+//flags that change how a font's glyphs are rendered, passed to DNUI_load_font_ex() and DNUI_bake_font()
+typedef enum DNUIfontFlags
+{
+	DNUI_FONT_MSDF = 1 << 0,          //render multi-channel distance fields, which stay sharp at corners when drawn much larger than the font's size. Uses 3 times the atlas memory per glyph
+	DNUI_FONT_COMPRESSED = 1 << 1,    //store the atlas as RGTC1 (BC4) blocks on the GPU, halving its memory. Ignored for DNUI_FONT_MSDF fonts, and the atlas is left uncompressed if RGTC isn't supported
+	DNUI_FONT_TEXTURE_ARRAY = 1 << 2, //store the atlas as a layer of a texture array shared with every other font using this flag and the same atlas format, so their text can be batched together.
+	                                  //every layer is as large as the largest atlas in the array, so fonts of similar sizes should share one
+	DNUI_FONT_FAST_SDF = 1 << 3       //generate distance fields from each glyph's outline with DNUI's vectorized generator, instead of rasterizing it and converting the bitmap with FreeType's
+	                                  //FT_RENDER_MODE_SDF. Many times faster, the fields differ by about 1/255 on average. Ignored for DNUI_FONT_MSDF fonts
+} DNUIfontFlags;
+
+//a single glyph of a font, stored in the font's glyph table
+typedef struct DNUIglyph
+{
+	uint32_t codepoint;    //the unicode codepoint of the glyph
+	bool loaded;           //whether this entry of the glyph table is in use
+	bool resident;         //whether the glyph's bitmap is currently in the texture atlas
+
+	float advance;         //how far the pen should advance after drawing this glyph, in pixels
+	float bmpW;            //the glpyh's bitmap width, in pixels
+	float bmpH;            //the glpyh's bitmap height, in pixels
+	float bmpL;            //the position of the left edge of the glyph's bitmap, in pixels
+	float bmpT;            //the position of the top edge of the glyph's bitmap, in pixels
+	float texL;            //the position of the left edge of the glyph in the texture atlas, in uv coordinates
+	float texT;            //the position of the top edge of the glyph in the texture atlas, in uv coordinates
+	float texR;            //the position of the right edge of the glyph in the texture atlas, in uv coordinates
+	float texB;            //the position of the bottom edge of the glyph in the texture atlas, in uv coordinates
+	int atlasX, atlasY;    //the position of the glyph's bitmap in the texture atlas, in pixels
+	unsigned int lastUsed; //the font's useStamp when the glyph was last drawn
+} DNUIglyph;
+
+//represents a font for text rendering at a single size, glyphs are rendered into the atlas the first time they are used.
+//every size loaded from the same file is a handle to one shared font, which owns the glyph table and atlas and is drawn scaled
 typedef struct DNUIfont
 {
-	unsigned int textureAtlas;   //the openGL handle to the texture atlas
-	unsigned int atlasW, atlasH; //the texture atlas' size, in pixels
+	unsigned int textureAtlas;   //the openGL handle to the texture atlas, a GL_TEXTURE_2D_ARRAY shared with other fonts if loaded with DNUI_FONT_TEXTURE_ARRAY. 0 until DNUI_upload_font_atlas() for fonts loaded with DNUI_load_font_metrics()
+	unsigned int atlasLayer;     //the layer of the texture array holding the atlas, 0 if the font doesn't use one
+	unsigned int atlasW, atlasH; //the texture atlas' size, in pixels (only set on the shared font)
 	float maxBearing;            //the maximum bearing of the character, in pixels
+	float lineHeight;            //the height of a line of text, in pixels
 
-	struct
-	{
-		float advance;   //how far the pen should advance after drawing this glyph, in pixels
-		float bmpW;      //the glpyh's bitmap width, in pixels
-		float bmpH;      //the glpyh's bitmap height, in pixels
-		float bmpL;      //the position of the left edge of the glyph's bitmap, in pixels
-		float bmpT;      //the position of the top edge of the glyph's bitmap, in pixels
-		float texOffset; //the offset of the glyph in the texture atlas, in uv coordinates
-	} glyphInfo[128];
+	DNUIglyph* glyphs;           //hash table of every glyph loaded so far, keyed by codepoint, with metrics at the shared font's size (only set on the shared font)
+	unsigned int numGlyphs;      //the number of glyphs in the table (only set on the shared font)
+	unsigned int glyphCapacity;  //the size of the glyph table, always a power of 2 (only set on the shared font)
+	unsigned int useStamp;       //incremented every time text is drawn, when the atlas is full the least recently used glyphs get evicted (only set on the shared font)
+
+	float sizeScale;             //the font's size relative to the shared font's size
+	struct DNUIfont* shared;     //the font that owns the glyphs, shared with every other size loaded from the same file
+
+	struct _DNUIfontInternal* internal; //the FreeType faces and atlas packing state, only used by DNUI
 } DNUIfont;
 
-/* Loads a font from a TrueType font file
+/* Loads a font from a TrueType font file. If the file is already loaded, the new size shares its glyphs and atlas instead of rendering them again,
+ * so the first size loaded is the one glyphs are rendered at and should be the largest (or use DNUI_FONT_MSDF, which scales up cleanly)
  * @param path the file path to the .ttf file
  * @param size the height of each glyph, in pixels, larger values may take significantly longer to load
  * @returns the loaded font, or NULL on failure
  */
 DNUIfont* DNUI_load_font(const char* path, int size);
-/* Frees a font from memory, must be called to avoid memory leaks
+/* Loads a font from a TrueType font file, with extra options. Shares glyphs with previous loads the same way as DNUI_load_font()
+ * @param path the file path to the .ttf file
+ * @param faceIndex the index of the face to load from the file, for collections (.ttc) with more than one
+ * @param size the height of each glyph, in pixels. Fonts loaded with DNUI_FONT_MSDF can use much smaller sizes and still be drawn sharply at large scales
+ * @param flags a combination of DNUIfontFlags
+ * @returns the loaded font, or NULL on failure
+ */
+DNUIfont* DNUI_load_font_ex(const char* path, int faceIndex, int size, unsigned int flags);
+/* Loads only a font's metrics, without creating its atlas or making any openGL calls, so text can be measured and wrapped before a context exists (or on a server that never has one).
+ * Does not require DNUI_init() to have been called. Takes the same parameters as DNUI_load_font_ex() and shares glyphs with it the same way.
+ * Once loaded, the font can be measured from any thread, but loading and freeing fonts must happen on one thread
+ * @returns the loaded font, or NULL on failure
+ */
+DNUIfont* DNUI_load_font_metrics(const char* path, int faceIndex, int size, unsigned int flags);
+/* Renders the glyphs of a font loaded with DNUI_load_font_metrics() into its atlas and uploads it, must be called on the thread with the openGL context.
+ * Drawing a font uploads its atlas automatically, this allows doing so ahead of time. Does nothing if the atlas was already uploaded
+ * @param font the font to upload
+ * @returns true on success, false on failure
+ */
+bool DNUI_upload_font_atlas(DNUIfont* font);
+/* Loads a font on a background thread, returning its handle straight away. Takes the same parameters as DNUI_load_font_ex() and shares glyphs with it the same way.
+ * The font becomes ready in the first DNUI_begin_frame() after it finishes loading, which uploads its atlas. Until then, drawing it does nothing and it measures as an
+ * empty string one line tall, with lineHeight and maxBearing set to its size. Calling DNUI_upload_font_atlas() or DNUI_add_fallback_font() waits for it to finish instead
+ * @returns the font's handle. If loading fails, an error is printed and the font never becomes ready
+ */
+DNUIfont* DNUI_load_font_async(const char* path, int faceIndex, int size, unsigned int flags);
+/* @returns whether a font can be drawn and measured, only false for fonts still being loaded by DNUI_load_font_async(). Must be called on the thread with the openGL context
+ */
+bool DNUI_font_ready(const DNUIfont* font);
+/* Loads a font baked with DNUI_bake_font(), without running FreeType. Only the glyphs that were baked can be drawn
+ * @param path the file path to the baked font
+ * @returns the loaded font, or NULL on failure
+ */
+DNUIfont* DNUI_load_baked_font(const char* path);
+/* Renders a font's glyphs and writes them, along with their metrics and kerning, to a file that can be loaded with DNUI_load_baked_font().
+ * Does not require DNUI_init() to have been called
+ * @param path the file path to the .ttf file
+ * @param size the height of each glyph, in pixels
+ * @param flags a combination of DNUIfontFlags
+ * @param codepoints the codepoints to bake, codepoints the font lacks are skipped
+ * @param numCodepoints the number of elements in codepoints
+ * @param outPath the file path to write the baked font to
+ * @returns true on success, false on failure
+ */
+bool DNUI_bake_font(const char* path, int size, unsigned int flags, const uint32_t* codepoints, int numCodepoints, const char* outPath);
+/* Frees a font from memory, must be called to avoid memory leaks. The shared glyphs and atlas are freed along with the last size using them
  * @param font the font to free
  */
 void DNUI_free_font(DNUIfont* font);
+/* Sets how many threads are used to render a font's glyphs when loading it, the calling thread counts as one of them
+ * @param count the number of threads to use, 0 to use one per core (the default)
+ */
+void DNUI_set_font_load_threads(unsigned int count);
+/* Adds a fallback font, checked for glyphs the font (and any earlier fallbacks) lacks. Glyphs are rendered at the font's size.
+ * The fallback applies to every size sharing the font's glyphs. Glyphs that were already loaded as the font's missing glyph are loaded again, and cached string sizes and layouts of the font are dropped,
+ * but elements only measure their text again when it changes, so it's best called before creating any that need it
+ * @param font the font to add the fallback to
+ * @param path the file path to the fallback's .ttf file
+ * @returns true on success, false on failure
+ */
+bool DNUI_add_fallback_font(DNUIfont* font, const char* path);
+
+/* Decodes a single utf-8 encoded codepoint, invalid sequences decode to U+FFFD
+ * @param text the string to decode from
+ * @param codepoint populated with the decoded codepoint
+ * @returns the number of bytes the codepoint takes up
+ */
+int DNUI_utf8_decode(const char* text, uint32_t* codepoint);
+/* Decodes a single utf-8 encoded codepoint from text that isn't null terminated, sequences cut off by the end of the text decode to U+FFFD
+ * @param len the number of bytes left in the text, must be at least 1
+ */
+int DNUI_utf8_decode_n(const char* text, size_t len, uint32_t* codepoint);
+/* Encodes a single codepoint as utf-8
+ * @param codepoint the codepoint to encode
+ * @param out populated with the encoded codepoint, must have space for at least 4 chars. Not null terminated
+ * @returns the number of bytes written
+ */
+int DNUI_utf8_encode(uint32_t codepoint, char* out);
+/* @returns the number of codepoints in a utf-8 encoded string
+ */
+int DNUI_utf8_length(const char* text);
+/* @returns the number of codepoints in the first len bytes of a utf-8 encoded string
+ */
+int DNUI_utf8_length_n(const char* text, size_t len);
 
 /* Calculates the size of a single-line string when rendered to the screen
- * @param text the string to calculate
+ * @param text the string to calculate, in utf-8
  * @param font the handle to the font to use
  * @param scale the scale of the text, a scale of 1.0 means that the font will be rendered at its actual resolution
- * @param charPositions an array populated with the start and end x position of each char when rendered ({start, end}), in pixels. Ignored if NULL
+ * @param charPositions an array populated with the start and end x position of each codepoint when rendered ({start, end}), in pixels. Ignored if NULL
  * @returns the size of the string when rendered, in pixels
  */
 DNvec2 DNUI_line_render_size(const char* text, DNUIfont* font, float scale, DNvec2* charPositions);
+/* Same as DNUI_line_render_size(), but measures the first len bytes of text, which doesn't need to be null terminated. The _n variants of the text functions
+ * skip finding the string's length, and allow substrings to be used without copying them
+ */
+DNvec2 DNUI_line_render_size_n(const char* text, size_t len, DNUIfont* font, float scale, DNvec2* charPositions);
 /* Calculates the size of a string when rendered to the screen
  * @param text the string to calculate
  * @param font the handle to the font to use
@@ -79,6 +214,9 @@ DNvec2 DNUI_line_render_size(const char* text, DNUIfont* font, float scale, DNve
  * @returns the size of the string when rendered, in pixels
  */
 DNvec2 DNUI_string_render_size(const char* text, DNUIfont* font, float scale, float wrap);
+/* Same as DNUI_string_render_size(), but measures the first len bytes of text, which doesn't need to be null terminated
+ */
+DNvec2 DNUI_string_render_size_n(const char* text, size_t len, DNUIfont* font, float scale, float wrap);
 /* Renders a string to the screen
  * @param text the string to render
  * @param font the handle to the font to use
@@ -94,6 +232,9 @@ DNvec2 DNUI_string_render_size(const char* text, DNUIfont* font, float scale, fl
  * @param outlineSoftness the softness of the outline's edges, 0.05 is the default value
  */
 void DNUI_draw_string(const char* text, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness);
+/* Same as DNUI_draw_string(), but renders the first len bytes of text, which doesn't need to be null terminated
+ */
+void DNUI_draw_string_n(const char* text, size_t len, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness);
 /* Renders a string to the screen, same as DNUI_draw_string() but with fewer parameters
  * @param text the string to render
  * @param font the handle to the font to use
@@ -104,10 +245,105 @@ void DNUI_draw_string(const char* text, DNUIfont* font, DNvec2 pos, float scale,
  * @param color the color of the text, in rgba format
  */
 void DNUI_draw_string_simple(const char* text, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color);
+/* Same as DNUI_draw_string_simple(), but renders the first len bytes of text, which doesn't need to be null terminated
+ */
+void DNUI_draw_string_simple_n(const char* text, size_t len, DNUIfont* font, DNvec2 pos, float scale, float wrap, int align, DNvec4 color);
+
+//a line of a DNUItextLayout
+typedef struct DNUItextLine
+{
+	int firstGlyph, numGlyphs; //the layout's glyphs on the line
+	int textStart, textEnd;    //the range of bytes of the text on the line, textEnd is exclusive
+	float x;                   //the line's left edge relative to the layout's, set by the alignment, in pixels
+	float w;                   //the line's width, in pixels
+} DNUItextLine;
+
+//a string broken into lines and positioned once, so it can be drawn, measured and hit tested without being laid out again.
+//must be zero initialized before the first DNUI_layout_string(), later calls reuse its arrays
+typedef struct DNUItextLayout
+{
+	DNUIfont* font;       //the handle to the font the string was laid out with
+	float scale;          //the scale the string was laid out at
+	DNvec2 size;          //the size of the string when rendered, in pixels, the same as DNUI_string_render_size() returns
+	float lineHeight;     //the distance between lines, in pixels
+
+	int numGlyphs;
+	uint32_t* codepoints; //the codepoint of each glyph, glyphs are looked up in the font by codepoint
+	DNvec2* positions;    //the start (x) and end (y) of each glyph's advance, relative to its line's left edge, in pixels
+	int* textOffsets;     //the byte offset of each glyph in the string
+	int numLines;
+	DNUItextLine* lines;
+
+	int glyphCapacity, lineCapacity; //the allocated size of the arrays
+} DNUItextLayout;
+
+/* Lays out a string, breaking it into lines the same way DNUI_draw_string() does. Can be called from any thread, like measuring
+ * @param text the string to lay out, in utf-8
+ * @param font the handle to the font to use
+ * @param scale the scale of the text, a scale of 1.0 means that the font will be rendered at its actual resolution
+ * @param wrap the maximum number of pixels the string can extend horizontally before wrapping to a new line. Set to 0 if no wrapping is desired
+ * @param align how to align the text when wrapping: 0 = align left (all lines start at left side), 1 = align right (all lines end at right side), 2 = align center (all lines are individually centered)
+ * @param layout populated with the layout, only the string's positions are stored so it doesn't need to be kept
+ */
+void DNUI_layout_string(const char* text, DNUIfont* font, float scale, float wrap, int align, DNUItextLayout* layout);
+/* Same as DNUI_layout_string(), but lays out the first len bytes of text, which doesn't need to be null terminated. The layout's text offsets are relative to text
+ */
+void DNUI_layout_string_n(const char* text, size_t len, DNUIfont* font, float scale, float wrap, int align, DNUItextLayout* layout);
+/* Frees a layout's arrays, it can be laid out again afterwards
+ */
+void DNUI_free_text_layout(DNUItextLayout* layout);
+/* Renders a laid out string to the screen, same as DNUI_draw_string() without laying it out again. The layout's font must not have been freed
+ * @param layout the layout to render
+ * @param pos the position of the center of the string, in pixels
+ * @param color the color of the text, in rgba format
+ * @param thickness the thickness of the text, 0.5 is the default value
+ * @param softness the softness of the text's edges, 0.05 is the default value
+ * @param outlineColor the color of the text's outline, in rgba format
+ * @param outlineThickness the thickness at which the text's outline begins. Set to 1.0 if no outline is desired
+ * @param outlineSoftness the softness of the outline's edges, 0.05 is the default value
+ */
+void DNUI_draw_text_layout(const DNUItextLayout* layout, DNvec2 pos, DNvec4 color, float thickness, float softness, DNvec4 outlineColor, float outlineThickness, float outlineSoftness);
+/* Finds the text cursor position closest to a point, such as where the mouse was clicked
+ * @param layout the layout to test against
+ * @param pos the position of the center of the string, as passed to DNUI_draw_text_layout()
+ * @param point the point to test, in pixels
+ * @returns the byte offset in the string of the closest gap between glyphs, on the closest line to the point
+ */
+int DNUI_text_layout_hit_test(const DNUItextLayout* layout, DNvec2 pos, DNvec2 point);
+
+/* Starts queueing text instead of drawing it straight away, so consecutive strings that use the same texture are drawn in a single call.
+ * Fonts loaded with DNUI_FONT_TEXTURE_ARRAY share a texture, so strings in different fonts can be batched too. Other DNUI draws send the queued text first,
+ * so the draw order is kept, but drawing with openGL directly doesn't, call DNUI_end_text_batch() before doing so
+ */
+void DNUI_begin_text_batch();
+/* Draws any queued text and stops queueing, see DNUI_begin_text_batch()
+ */
+void DNUI_end_text_batch();
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 //RECT RENDERING:
 
+#define DNUI_MAX_GRADIENT_STOPS 8
+
+//the shape of a gradient
+typedef enum DNUIgradientType
+{
+	DNUI_GRADIENT_NONE,
+	DNUI_GRADIENT_LINEAR,
+	DNUI_GRADIENT_RADIAL
+} DNUIgradientType;
+
+//represents a gradient that is evaluated procedurally when rendering a rectangle
+typedef struct DNUIgradient
+{
+	DNUIgradientType type;
+	DNvec2 start;                                //the start point (linear) or center (radial) of the gradient, in uv coordinates ({0, 0} is the rect's bottom left, {1, 1} is its top right)
+	DNvec2 end;                                  //the end point (linear) or a point on the outer edge (radial) of the gradient, in uv coordinates
+	int numStops;                                //the number of color stops, must be between 1 and DNUI_MAX_GRADIENT_STOPS
+	DNvec4 colors[DNUI_MAX_GRADIENT_STOPS];      //the color of each stop, in rgba format
+	float positions[DNUI_MAX_GRADIENT_STOPS];    //the position of each stop, 0.0 is the start point and 1.0 is the end point. Must be in increasing order
+} DNUIgradient;
+
 /* Renders a rectangle to the screen
  * @param textureHandle a handle to an openGL texture to render, set to -1 if no texture is desired
  * @param center the position of the rectangle's center, in pixels. {0, 0} denotes the center of the screen
@@ -119,6 +355,94 @@ void DNUI_draw_string_simple(const char* text, DNUIfont* font, DNvec2 pos, float
  * @param outlineThickness the thickness of the rectangle's outline, in pixels, or 0 if no outline is desired
  */
 void DNUI_draw_rect(int textureHandle, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+/* Renders a rectangle filled with a gradient to the screen
+ * @param textureHandle a handle to an openGL texture to render, set to -1 if no texture is desired
+ * @param gradient the gradient to fill the rectangle with
+ * @param center the position of the rectangle's center, in pixels. {0, 0} denotes the center of the screen
+ * @param size the size, in pixels, of the rectangle
+ * @param angle the angle, in degrees, to rotate the rectangle
+ * @param color the color to multiply the gradient by, in rgba format. If a texture is used, it will also be multiplied by the texture's color
+ * @param cornerRad used to add rounded corners. denotes the radius of the rectangles corners, in pixels
+ * @param outlineColor the color of the rectangle's outline, if one is desired
+ * @param outlineThickness the thickness of the rectangle's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_rect_gradient(int textureHandle, const DNUIgradient* gradient, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+/* Renders a nine-sliced textured rectangle to the screen, the texture's corners keep their size while its edges and center stretch to fill the rectangle
+ * @param textureHandle a handle to the openGL texture to render
+ * @param insets the size of the texture's borders, in texels ({left, right, top, bottom})
+ * @param borderScale the number of pixels each border texel should take up on screen
+ * @param center the position of the rectangle's center, in pixels. {0, 0} denotes the center of the screen
+ * @param size the size, in pixels, of the rectangle
+ * @param angle the angle, in degrees, to rotate the rectangle
+ * @param color the color of the rectangle, in rgba format. The final color will be the texture's color multiplied by this
+ * @param cornerRad used to add rounded corners. denotes the radius of the rectangles corners, in pixels
+ * @param outlineColor the color of the rectangle's outline, if one is desired
+ * @param outlineThickness the thickness of the rectangle's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_rect_nine_slice(int textureHandle, DNvec4 insets, float borderScale, DNvec2 center, DNvec2 size, float angle, DNvec4 color, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+/* Renders a rectangle to the screen that blurs everything rendered behind it. The framebuffer is only captured and blurred once per frame,
+ * on the first call after DNUI_begin_frame(), so anything rendered after that will not appear in the blur
+ * @param center the position of the rectangle's center, in pixels. {0, 0} denotes the center of the screen
+ * @param size the size, in pixels, of the rectangle
+ * @param angle the angle, in degrees, to rotate the rectangle
+ * @param tint the color to tint the blur with, in rgba format. The alpha component determines how strongly the blur is tinted
+ * @param opacity the opacity of the entire rectangle
+ * @param cornerRad used to add rounded corners. denotes the radius of the rectangles corners, in pixels
+ * @param outlineColor the color of the rectangle's outline, if one is desired
+ * @param outlineThickness the thickness of the rectangle's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_rect_blurred(DNvec2 center, DNvec2 size, float angle, DNvec4 tint, float opacity, float cornerRad, DNvec4 outlineColor, float outlineThickness);
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+//SHAPE RENDERING:
+
+/* Renders a circle to the screen
+ * @param center the position of the circle's center, in pixels. {0, 0} denotes the center of the screen
+ * @param radius the radius of the circle, in pixels
+ * @param color the color of the circle, in rgba format
+ * @param outlineColor the color of the circle's outline, if one is desired
+ * @param outlineThickness the thickness of the circle's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_circle(DNvec2 center, float radius, DNvec4 color, DNvec4 outlineColor, float outlineThickness);
+/* Renders a section of a ring to the screen, useful for radial progress bars
+ * @param center the position of the ring's center, in pixels. {0, 0} denotes the center of the screen
+ * @param radius the radius of the ring, measured to the middle of its thickness, in pixels
+ * @param thickness the thickness of the ring, in pixels
+ * @param startAngle the angle the arc begins at, in degrees. 0 points to the right, and angles increase counterclockwise
+ * @param endAngle the angle the arc ends at, in degrees. Set 360 degrees apart from startAngle for a full ring
+ * @param color the color of the arc, in rgba format
+ * @param outlineColor the color of the arc's outline, if one is desired
+ * @param outlineThickness the thickness of the arc's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_arc(DNvec2 center, float radius, float thickness, float startAngle, float endAngle, DNvec4 color, DNvec4 outlineColor, float outlineThickness);
+/* Renders a line segment with rounded ends to the screen
+ * @param start the position of the line's first point, in pixels. {0, 0} denotes the center of the screen
+ * @param end the position of the line's second point, in pixels
+ * @param thickness the thickness of the line, in pixels
+ * @param color the color of the line, in rgba format
+ * @param outlineColor the color of the line's outline, if one is desired
+ * @param outlineThickness the thickness of the line's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_line(DNvec2 start, DNvec2 end, float thickness, DNvec4 color, DNvec4 outlineColor, float outlineThickness);
+/* Renders a connected series of line segments to the screen, useful for graphs
+ * @param points the positions of each point along the line, in pixels. {0, 0} denotes the center of the screen
+ * @param numPoints the number of points, must be at least 2
+ * @param thickness the thickness of the line, in pixels
+ * @param color the color of the line, in rgba format
+ * @param outlineColor the color of the line's outline, if one is desired
+ * @param outlineThickness the thickness of the line's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_polyline(const DNvec2* points, int numPoints, float thickness, DNvec4 color, DNvec4 outlineColor, float outlineThickness);
+/* Renders a triangle to the screen
+ * @param a the position of the triangle's first corner, in pixels. {0, 0} denotes the center of the screen
+ * @param b the position of the triangle's second corner, in pixels
+ * @param c the position of the triangle's third corner, in pixels
+ * @param cornerRad used to add rounded corners. denotes the radius of the triangle's corners, in pixels. The triangle grows by this amount
+ * @param color the color of the triangle, in rgba format
+ * @param outlineColor the color of the triangle's outline, if one is desired
+ * @param outlineThickness the thickness of the triangle's outline, in pixels, or 0 if no outline is desired
+ */
+void DNUI_draw_triangle(DNvec2 a, DNvec2 b, DNvec2 c, float cornerRad, DNvec4 color, DNvec4 outlineColor, float outlineThickness);
 
 //--------------------------------------------------------------------------------------------------------------------------------//
 
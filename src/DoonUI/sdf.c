@@ -0,0 +1,842 @@
+#include "sdf.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include FT_OUTLINE_H
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define DNUI_SDF_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DNUI_SDF_SSE2
+#endif
+
+#define DNUI_MSDF_FLATNESS 0.01f           //the maximum distance between a curve and the line segments it gets flattened into, in pixels
+#define DNUI_MSDF_MAX_CURVE_SEGMENTS 64    //the maximum number of line segments a single curve gets flattened into
+#define DNUI_MSDF_CORNER_THRESHOLD 0.1411f //sin(3 radians), edges whose directions differ by more than this form a corner
+#define DNUI_MSDF_CLASH_THRESHOLD 1.001f   //how much a pixel's channels can differ from a neighbour's, in pixels, before being treated as an artifact
+#define DNUI_SDF_CELL_SIZE 8               //the size of the grid cells segments are sorted into for single-channel fields, in pixels. One row of a cell fills an avx register
+
+//the channels an edge contributes its distance to, as a bitmask of red, green and blue
+enum
+{
+	_DNUI_EDGE_BLACK   = 0,
+	_DNUI_EDGE_RED     = 1,
+	_DNUI_EDGE_GREEN   = 2,
+	_DNUI_EDGE_YELLOW  = 3,
+	_DNUI_EDGE_BLUE    = 4,
+	_DNUI_EDGE_MAGENTA = 5,
+	_DNUI_EDGE_CYAN    = 6,
+	_DNUI_EDGE_WHITE   = 7
+};
+
+typedef struct _DNUIsdfVec
+{
+	float x, y;
+} _DNUIsdfVec;
+
+//an edge of an outline, lines and quadratic curves are stored as cubic curves so every edge can be handled the same way
+typedef struct _DNUIsdfEdge
+{
+	_DNUIsdfVec p[4];
+	int color;
+} _DNUIsdfEdge;
+
+//a straight piece of a flattened edge
+typedef struct _DNUIsdfSegment
+{
+	_DNUIsdfVec a, b;
+	int color;
+	bool edgeStart, edgeEnd; //whether the segment begins or ends its edge, only the ends of edges are extended when computing pseudo-distances
+} _DNUIsdfSegment;
+
+//a segment prepared for the single-channel distance kernel
+typedef struct _DNUIsdfLine
+{
+	float ax, ay;   //the segment's start
+	float dx, dy;   //the vector from the segment's start to its end
+	float invLenSq; //1 / (dx * dx + dy * dy)
+} _DNUIsdfLine;
+
+//a point where a row of pixels' centers crosses the outline
+typedef struct _DNUIsdfCrossing
+{
+	float x;
+	int dir; //+1 if the outline crosses upwards, -1 if downwards
+} _DNUIsdfCrossing;
+
+//an outline being decomposed into edges
+typedef struct _DNUIsdfShape
+{
+	_DNUIsdfEdge* edges;
+	int numEdges, maxEdges;
+	int* contours; //the index of each contour's first edge
+	int numContours, maxContours;
+	_DNUIsdfVec pen;
+} _DNUIsdfShape;
+
+//the closest segment to a pixel found so far, for a single channel
+typedef struct _DNUIsdfClosest
+{
+	float dist;  //the signed distance to the segment, positive inside
+	float ortho; //how far from perpendicular the direction to the closest point is, used to pick between segments that are equally close
+	float param; //the position of the closest point along the segment, between 0 and 1 if it isn't an endpoint
+	const _DNUIsdfSegment* segment;
+} _DNUIsdfClosest;
+
+static void _DNUI_sdf_add_edge(_DNUIsdfShape* shape, _DNUIsdfVec p0, _DNUIsdfVec p1, _DNUIsdfVec p2, _DNUIsdfVec p3);
+static void _DNUI_sdf_end_contour(_DNUIsdfShape* shape);
+static void _DNUI_sdf_color_contour(_DNUIsdfEdge* edges, int numEdges, int* color);
+static _DNUIsdfSegment* _DNUI_sdf_flatten(const _DNUIsdfShape* shape, int* numSegments);
+static void _DNUI_sdf_cell_distances(const _DNUIsdfLine* lines, const int* indices, int numIndices, float x, float y, float* dists);
+static int _DNUI_sdf_compare_crossings(const void* a, const void* b);
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static _DNUIsdfVec _DNUI_sdf_point(const FT_Vector* v)
+{
+	return (_DNUIsdfVec){v->x / 64.0f, v->y / 64.0f};
+}
+
+static _DNUIsdfVec _DNUI_sdf_lerp(_DNUIsdfVec a, _DNUIsdfVec b, float t)
+{
+	return (_DNUIsdfVec){a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+}
+
+static _DNUIsdfVec _DNUI_sdf_normalize(_DNUIsdfVec v)
+{
+	float len = sqrtf(v.x * v.x + v.y * v.y);
+	return len > 0.0f ? (_DNUIsdfVec){v.x / len, v.y / len} : (_DNUIsdfVec){0.0f, 1.0f};
+}
+
+static _DNUIsdfVec _DNUI_sdf_cubic_point(const _DNUIsdfEdge* edge, float t)
+{
+	_DNUIsdfVec a = _DNUI_sdf_lerp(edge->p[0], edge->p[1], t);
+	_DNUIsdfVec b = _DNUI_sdf_lerp(edge->p[1], edge->p[2], t);
+	_DNUIsdfVec c = _DNUI_sdf_lerp(edge->p[2], edge->p[3], t);
+	return _DNUI_sdf_lerp(_DNUI_sdf_lerp(a, b, t), _DNUI_sdf_lerp(b, c, t), t);
+}
+
+//the direction of an edge where it starts, skipping control points that lie on the endpoint
+static _DNUIsdfVec _DNUI_sdf_start_dir(const _DNUIsdfEdge* edge)
+{
+	for(int i = 1; i < 4; i++)
+		if(edge->p[i].x != edge->p[0].x || edge->p[i].y != edge->p[0].y)
+			return _DNUI_sdf_normalize((_DNUIsdfVec){edge->p[i].x - edge->p[0].x, edge->p[i].y - edge->p[0].y});
+
+	return (_DNUIsdfVec){0.0f, 0.0f};
+}
+
+//the direction of an edge where it ends, skipping control points that lie on the endpoint
+static _DNUIsdfVec _DNUI_sdf_end_dir(const _DNUIsdfEdge* edge)
+{
+	for(int i = 2; i >= 0; i--)
+		if(edge->p[i].x != edge->p[3].x || edge->p[i].y != edge->p[3].y)
+			return _DNUI_sdf_normalize((_DNUIsdfVec){edge->p[3].x - edge->p[i].x, edge->p[3].y - edge->p[i].y});
+
+	return (_DNUIsdfVec){0.0f, 0.0f};
+}
+
+static float _DNUI_sdf_median(float a, float b, float c)
+{
+	return fmaxf(fminf(a, b), fminf(fmaxf(a, b), c));
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static int _DNUI_sdf_move_to(const FT_Vector* to, void* user)
+{
+	_DNUIsdfShape* shape = user;
+	_DNUI_sdf_end_contour(shape);
+
+	if(shape->numContours >= shape->maxContours)
+	{
+		shape->maxContours = shape->maxContours > 0 ? shape->maxContours * 2 : 8;
+		shape->contours = realloc(shape->contours, shape->maxContours * sizeof(int));
+	}
+
+	shape->contours[shape->numContours++] = shape->numEdges;
+	shape->pen = _DNUI_sdf_point(to);
+	return 0;
+}
+
+static int _DNUI_sdf_line_to(const FT_Vector* to, void* user)
+{
+	_DNUIsdfShape* shape = user;
+	_DNUIsdfVec a = shape->pen;
+	_DNUIsdfVec b = _DNUI_sdf_point(to);
+
+	_DNUI_sdf_add_edge(shape, a, _DNUI_sdf_lerp(a, b, 1.0f / 3.0f), _DNUI_sdf_lerp(a, b, 2.0f / 3.0f), b);
+	return 0;
+}
+
+static int _DNUI_sdf_conic_to(const FT_Vector* control, const FT_Vector* to, void* user)
+{
+	_DNUIsdfShape* shape = user;
+	_DNUIsdfVec a = shape->pen;
+	_DNUIsdfVec c = _DNUI_sdf_point(control);
+	_DNUIsdfVec b = _DNUI_sdf_point(to);
+
+	_DNUI_sdf_add_edge(shape, a, _DNUI_sdf_lerp(a, c, 2.0f / 3.0f), _DNUI_sdf_lerp(b, c, 2.0f / 3.0f), b);
+	return 0;
+}
+
+static int _DNUI_sdf_cubic_to(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user)
+{
+	_DNUIsdfShape* shape = user;
+	_DNUI_sdf_add_edge(shape, shape->pen, _DNUI_sdf_point(control1), _DNUI_sdf_point(control2), _DNUI_sdf_point(to));
+	return 0;
+}
+
+static void _DNUI_sdf_add_edge(_DNUIsdfShape* shape, _DNUIsdfVec p0, _DNUIsdfVec p1, _DNUIsdfVec p2, _DNUIsdfVec p3)
+{
+	shape->pen = p3;
+
+	//degenerate edges, such as the zero-length line closing most contours, would only confuse the edge coloring:
+	if(p0.x == p3.x && p0.y == p3.y && p0.x == p1.x && p0.y == p1.y && p0.x == p2.x && p0.y == p2.y)
+		return;
+
+	if(shape->numEdges >= shape->maxEdges)
+	{
+		shape->maxEdges = shape->maxEdges > 0 ? shape->maxEdges * 2 : 32;
+		shape->edges = realloc(shape->edges, shape->maxEdges * sizeof(_DNUIsdfEdge));
+	}
+
+	shape->edges[shape->numEdges++] = (_DNUIsdfEdge){{p0, p1, p2, p3}, _DNUI_EDGE_WHITE};
+}
+
+static void _DNUI_sdf_end_contour(_DNUIsdfShape* shape)
+{
+	//contours need at least 3 edges to fit 3 colors, so shorter ones get each edge split into thirds:
+	//---------------------------------
+	if(shape->numContours == 0)
+		return;
+
+	int start = shape->contours[shape->numContours - 1];
+	int numEdges = shape->numEdges - start;
+	if(numEdges == 0 || numEdges >= 3)
+		return;
+
+	_DNUIsdfEdge edges[2];
+	memcpy(edges, &shape->edges[start], numEdges * sizeof(_DNUIsdfEdge));
+	shape->numEdges = start;
+
+	for(int i = 0; i < numEdges; i++)
+	{
+		//split with de casteljau's algorithm at 1/3, then split the remainder in half:
+		const _DNUIsdfVec* p = edges[i].p;
+		for(int j = 0; j < 3; j++)
+		{
+			float t = 1.0f / (3 - j);
+			_DNUIsdfVec ab = _DNUI_sdf_lerp(p[0], p[1], t);
+			_DNUIsdfVec bc = _DNUI_sdf_lerp(p[1], p[2], t);
+			_DNUIsdfVec cd = _DNUI_sdf_lerp(p[2], p[3], t);
+			_DNUIsdfVec abc = _DNUI_sdf_lerp(ab, bc, t);
+			_DNUIsdfVec bcd = _DNUI_sdf_lerp(bc, cd, t);
+			_DNUIsdfVec abcd = _DNUI_sdf_lerp(abc, bcd, t);
+
+			_DNUI_sdf_add_edge(shape, p[0], ab, abc, abcd);
+			edges[i] = (_DNUIsdfEdge){{abcd, bcd, cd, p[3]}, _DNUI_EDGE_WHITE};
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static int _DNUI_sdf_switch_color(int color, int banned)
+{
+	int combined = color & banned;
+	if(combined == _DNUI_EDGE_RED || combined == _DNUI_EDGE_GREEN || combined == _DNUI_EDGE_BLUE)
+		return combined ^ _DNUI_EDGE_WHITE;
+
+	if(color == _DNUI_EDGE_BLACK || color == _DNUI_EDGE_WHITE)
+		return _DNUI_EDGE_CYAN;
+
+	//rotate between cyan, magenta and yellow:
+	int shifted = color << 1;
+	return (shifted | shifted >> 3) & _DNUI_EDGE_WHITE;
+}
+
+static void _DNUI_sdf_color_contour(_DNUIsdfEdge* edges, int numEdges, int* color)
+{
+	//find corners, where an edge doesn't continue in the direction the previous one ended in:
+	//---------------------------------
+	int* corners = malloc(numEdges * sizeof(int));
+	int numCorners = 0;
+
+	_DNUIsdfVec prevDir = _DNUI_sdf_end_dir(&edges[numEdges - 1]);
+	for(int i = 0; i < numEdges; i++)
+	{
+		_DNUIsdfVec dir = _DNUI_sdf_start_dir(&edges[i]);
+		float dot = prevDir.x * dir.x + prevDir.y * dir.y;
+		float cross = prevDir.x * dir.y - prevDir.y * dir.x;
+		if(dot <= 0.0f || fabsf(cross) > DNUI_MSDF_CORNER_THRESHOLD)
+			corners[numCorners++] = i;
+
+		prevDir = _DNUI_sdf_end_dir(&edges[i]);
+	}
+
+	//color edges so the two edges at every corner share exactly one channel:
+	//---------------------------------
+	if(numCorners == 0) //smooth contours don't need multiple channels
+	{
+		*color = _DNUI_sdf_switch_color(*color, _DNUI_EDGE_BLACK);
+		for(int i = 0; i < numEdges; i++)
+			edges[i].color = *color;
+	}
+	else if(numCorners == 1) //a single corner, spread 3 colors across the contour so the edges meeting at the corner still differ
+	{
+		int colors[3];
+		*color = _DNUI_sdf_switch_color(*color, _DNUI_EDGE_BLACK);
+		colors[0] = *color;
+		colors[1] = _DNUI_EDGE_WHITE;
+		*color = _DNUI_sdf_switch_color(*color, _DNUI_EDGE_BLACK);
+		colors[2] = *color;
+
+		for(int i = 0; i < numEdges; i++)
+		{
+			int third = (int)(3.0f + 2.875f * i / (numEdges - 1) - 1.4375f + 0.5f) - 3;
+			edges[(corners[0] + i) % numEdges].color = colors[1 + third];
+		}
+	}
+	else //switch colors at every corner, making sure the last spline doesn't match the first
+	{
+		*color = _DNUI_sdf_switch_color(*color, _DNUI_EDGE_BLACK);
+		int initialColor = *color;
+		int spline = 0;
+
+		for(int i = 0; i < numEdges; i++)
+		{
+			int index = (corners[0] + i) % numEdges;
+			if(spline + 1 < numCorners && corners[spline + 1] == index)
+			{
+				spline++;
+				*color = _DNUI_sdf_switch_color(*color, spline == numCorners - 1 ? initialColor : _DNUI_EDGE_BLACK);
+			}
+
+			edges[index].color = *color;
+		}
+	}
+
+	free(corners);
+}
+
+static _DNUIsdfSegment* _DNUI_sdf_flatten(const _DNUIsdfShape* shape, int* numSegments)
+{
+	int maxSegments = shape->numEdges * 4;
+	_DNUIsdfSegment* segments = malloc(maxSegments * sizeof(_DNUIsdfSegment));
+	*numSegments = 0;
+
+	for(int i = 0; i < shape->numEdges; i++)
+	{
+		//the number of segments needed to stay within DNUI_MSDF_FLATNESS of the curve, from the bound on its second derivative:
+		//---------------------------------
+		const _DNUIsdfEdge* edge = &shape->edges[i];
+		const _DNUIsdfVec* p = edge->p;
+		float ddx = fmaxf(fabsf(p[0].x - 2.0f * p[1].x + p[2].x), fabsf(p[1].x - 2.0f * p[2].x + p[3].x));
+		float ddy = fmaxf(fabsf(p[0].y - 2.0f * p[1].y + p[2].y), fabsf(p[1].y - 2.0f * p[2].y + p[3].y));
+		int n = (int)ceilf(sqrtf(0.75f * sqrtf(ddx * ddx + ddy * ddy) / DNUI_MSDF_FLATNESS));
+		n = n < 1 ? 1 : (n > DNUI_MSDF_MAX_CURVE_SEGMENTS ? DNUI_MSDF_MAX_CURVE_SEGMENTS : n);
+
+		if(*numSegments + n > maxSegments)
+		{
+			while(*numSegments + n > maxSegments)
+				maxSegments *= 2;
+
+			segments = realloc(segments, maxSegments * sizeof(_DNUIsdfSegment));
+		}
+
+		//add segments, skipping any with no length:
+		//---------------------------------
+		int first = *numSegments;
+		_DNUIsdfVec a = p[0];
+		for(int j = 1; j <= n; j++)
+		{
+			_DNUIsdfVec b = j == n ? p[3] : _DNUI_sdf_cubic_point(edge, (float)j / n);
+			if(a.x == b.x && a.y == b.y)
+				continue;
+
+			bool edgeStart = *numSegments == first;
+			segments[(*numSegments)++] = (_DNUIsdfSegment){a, b, edge->color, edgeStart, false};
+			a = b;
+		}
+
+		if(*numSegments > first)
+			segments[*numSegments - 1].edgeEnd = true;
+	}
+
+	return segments;
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+static void _DNUI_sdf_segment_distance(const _DNUIsdfSegment* segment, _DNUIsdfVec p, float* dist, float* ortho, float* param)
+{
+	_DNUIsdfVec aq = {p.x - segment->a.x, p.y - segment->a.y};
+	_DNUIsdfVec ab = {segment->b.x - segment->a.x, segment->b.y - segment->a.y};
+	float len = sqrtf(ab.x * ab.x + ab.y * ab.y);
+	float cross = aq.x * ab.y - aq.y * ab.x;
+	*param = (aq.x * ab.x + aq.y * ab.y) / (len * len);
+
+	_DNUIsdfVec eq = *param > 0.5f ? (_DNUIsdfVec){segment->b.x - p.x, segment->b.y - p.y} : (_DNUIsdfVec){-aq.x, -aq.y};
+	float endDist = sqrtf(eq.x * eq.x + eq.y * eq.y);
+
+	if(*param > 0.0f && *param < 1.0f && fabsf(cross / len) < endDist)
+	{
+		*dist = cross / len;
+		*ortho = 0.0f;
+		return;
+	}
+
+	*dist = cross > 0.0f ? endDist : -endDist;
+	*ortho = endDist > 0.0f ? fabsf((ab.x * eq.x + ab.y * eq.y) / (len * endDist)) : 0.0f;
+}
+
+//beyond the ends of an edge, the distance to the edge's tangent is used instead, so the field stays straight up to corners
+static float _DNUI_sdf_pseudo_distance(const _DNUIsdfClosest* closest, _DNUIsdfVec p)
+{
+	const _DNUIsdfSegment* segment = closest->segment;
+	_DNUIsdfVec dir = _DNUI_sdf_normalize((_DNUIsdfVec){segment->b.x - segment->a.x, segment->b.y - segment->a.y});
+
+	_DNUIsdfVec q;
+	if(closest->param < 0.0f && segment->edgeStart)
+		q = (_DNUIsdfVec){p.x - segment->a.x, p.y - segment->a.y};
+	else if(closest->param > 1.0f && segment->edgeEnd)
+		q = (_DNUIsdfVec){p.x - segment->b.x, p.y - segment->b.y};
+	else
+		return closest->dist;
+
+	float along = q.x * dir.x + q.y * dir.y;
+	if((closest->param < 0.0f) != (along < 0.0f))
+		return closest->dist;
+
+	float pseudoDist = q.x * dir.y - q.y * dir.x;
+	return fabsf(pseudoDist) <= fabsf(closest->dist) ? pseudoDist : closest->dist;
+}
+
+//whether two neighbouring pixels have channels that change too quickly between them, which causes artifacts when interpolated
+static bool _DNUI_sdf_clash(const float* a, const float* b, float threshold)
+{
+	//sort channels from the largest difference to the smallest:
+	float a0 = a[0], a1 = a[1], a2 = a[2];
+	float b0 = b[0], b1 = b[1], b2 = b[2];
+	float tmp;
+
+	if(fabsf(b0 - a0) < fabsf(b1 - a1))
+	{
+		tmp = a0; a0 = a1; a1 = tmp;
+		tmp = b0; b0 = b1; b1 = tmp;
+	}
+	if(fabsf(b1 - a1) < fabsf(b2 - a2))
+	{
+		tmp = a1; a1 = a2; a2 = tmp;
+		tmp = b1; b1 = b2; b2 = tmp;
+		if(fabsf(b0 - a0) < fabsf(b1 - a1))
+		{
+			tmp = a0; a0 = a1; a1 = tmp;
+			tmp = b0; b0 = b1; b1 = tmp;
+		}
+	}
+
+	//only flag the pixel farther from the outline, and ignore neighbours that were already flattened:
+	return fabsf(b1 - a1) >= threshold && !(b0 == b1 && b0 == b2) && fabsf(a2 - 0.5f) >= fabsf(b2 - 0.5f);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+//finds the distance from the center of every pixel in a DNUI_SDF_CELL_SIZE * DNUI_SDF_CELL_SIZE cell to the closest of the given lines, clamped to DNUI_SDF_SPREAD.
+//x and y are the center of the cell's top left pixel, dists is filled row by row from the top
+static void _DNUI_sdf_cell_distances(const _DNUIsdfLine* lines, const int* indices, int numIndices, float x, float y, float* dists)
+{
+	const float maxDistSq = (float)DNUI_SDF_SPREAD * DNUI_SDF_SPREAD;
+
+	//every line is tested against a whole row of pixels at once, the closest point on the line is found by projecting onto it and clamping to its ends:
+	//---------------------------------
+#if defined(DNUI_SDF_AVX)
+	__m256 zero = _mm256_setzero_ps();
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 px = _mm256_add_ps(_mm256_set1_ps(x), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+
+	__m256 closest[DNUI_SDF_CELL_SIZE];
+	for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		closest[row] = _mm256_set1_ps(maxDistSq);
+
+	for(int i = 0; i < numIndices; i++)
+	{
+		const _DNUIsdfLine* line = &lines[indices[i]];
+		__m256 dx = _mm256_set1_ps(line->dx);
+		__m256 dy = _mm256_set1_ps(line->dy);
+		__m256 invLenSq = _mm256_set1_ps(line->invLenSq);
+		__m256 aqx = _mm256_sub_ps(px, _mm256_set1_ps(line->ax));
+		__m256 dotX = _mm256_mul_ps(aqx, dx);
+
+		for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		{
+			__m256 aqy = _mm256_set1_ps(y - row - line->ay);
+			__m256 t = _mm256_mul_ps(_mm256_add_ps(dotX, _mm256_mul_ps(aqy, dy)), invLenSq);
+			t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+
+			__m256 ex = _mm256_sub_ps(aqx, _mm256_mul_ps(t, dx));
+			__m256 ey = _mm256_sub_ps(aqy, _mm256_mul_ps(t, dy));
+			closest[row] = _mm256_min_ps(closest[row], _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)));
+		}
+	}
+
+	for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		_mm256_storeu_ps(&dists[row * DNUI_SDF_CELL_SIZE], _mm256_sqrt_ps(closest[row]));
+#elif defined(DNUI_SDF_SSE2)
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 px[2] = {_mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)), _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f))};
+
+	__m128 closest[DNUI_SDF_CELL_SIZE][2];
+	for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		closest[row][0] = closest[row][1] = _mm_set1_ps(maxDistSq);
+
+	for(int i = 0; i < numIndices; i++)
+	{
+		const _DNUIsdfLine* line = &lines[indices[i]];
+		__m128 dx = _mm_set1_ps(line->dx);
+		__m128 dy = _mm_set1_ps(line->dy);
+		__m128 invLenSq = _mm_set1_ps(line->invLenSq);
+		__m128 ax = _mm_set1_ps(line->ax);
+		__m128 aqx[2] = {_mm_sub_ps(px[0], ax), _mm_sub_ps(px[1], ax)};
+		__m128 dotX[2] = {_mm_mul_ps(aqx[0], dx), _mm_mul_ps(aqx[1], dx)};
+
+		for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		{
+			__m128 aqy = _mm_set1_ps(y - row - line->ay);
+			__m128 dotY = _mm_mul_ps(aqy, dy);
+
+			for(int half = 0; half < 2; half++)
+			{
+				__m128 t = _mm_mul_ps(_mm_add_ps(dotX[half], dotY), invLenSq);
+				t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+				__m128 ex = _mm_sub_ps(aqx[half], _mm_mul_ps(t, dx));
+				__m128 ey = _mm_sub_ps(aqy, _mm_mul_ps(t, dy));
+				closest[row][half] = _mm_min_ps(closest[row][half], _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+			}
+		}
+	}
+
+	for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+	{
+		_mm_storeu_ps(&dists[row * DNUI_SDF_CELL_SIZE], _mm_sqrt_ps(closest[row][0]));
+		_mm_storeu_ps(&dists[row * DNUI_SDF_CELL_SIZE + 4], _mm_sqrt_ps(closest[row][1]));
+	}
+#else
+	for(int i = 0; i < DNUI_SDF_CELL_SIZE * DNUI_SDF_CELL_SIZE; i++)
+		dists[i] = maxDistSq;
+
+	for(int i = 0; i < numIndices; i++)
+	{
+		const _DNUIsdfLine* line = &lines[indices[i]];
+		for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+		for(int col = 0; col < DNUI_SDF_CELL_SIZE; col++)
+		{
+			float aqx = x + col - line->ax;
+			float aqy = y - row - line->ay;
+			float t = (aqx * line->dx + aqy * line->dy) * line->invLenSq;
+			t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+			float ex = aqx - t * line->dx;
+			float ey = aqy - t * line->dy;
+			float distSq = ex * ex + ey * ey;
+			if(distSq < dists[row * DNUI_SDF_CELL_SIZE + col])
+				dists[row * DNUI_SDF_CELL_SIZE + col] = distSq;
+		}
+	}
+
+	for(int i = 0; i < DNUI_SDF_CELL_SIZE * DNUI_SDF_CELL_SIZE; i++)
+		dists[i] = sqrtf(dists[i]);
+#endif
+}
+
+static int _DNUI_sdf_compare_crossings(const void* a, const void* b)
+{
+	float xA = ((const _DNUIsdfCrossing*)a)->x;
+	float xB = ((const _DNUIsdfCrossing*)b)->x;
+	return (xA > xB) - (xA < xB);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+void _DNUI_get_sdf_bounds(const FT_Outline* outline, int* left, int* top, int* w, int* h)
+{
+	if(outline->n_points == 0)
+	{
+		*left = *top = *w = *h = 0;
+		return;
+	}
+
+	FT_BBox box;
+	FT_Outline_Get_CBox(outline, &box);
+
+	int minX = (int)floorf(box.xMin / 64.0f);
+	int minY = (int)floorf(box.yMin / 64.0f);
+	int maxX = (int)ceilf(box.xMax / 64.0f);
+	int maxY = (int)ceilf(box.yMax / 64.0f);
+
+	*left = minX - DNUI_SDF_SPREAD;
+	*top = maxY + DNUI_SDF_SPREAD;
+	*w = maxX - minX + 2 * DNUI_SDF_SPREAD;
+	*h = maxY - minY + 2 * DNUI_SDF_SPREAD;
+}
+
+void _DNUI_generate_msdf(const FT_Outline* outline, int left, int top, int w, int h, unsigned char* pixels)
+{
+	//decompose outline into colored line segments:
+	//---------------------------------
+	_DNUIsdfShape shape = {0};
+	FT_Outline_Funcs funcs = {_DNUI_sdf_move_to, _DNUI_sdf_line_to, _DNUI_sdf_conic_to, _DNUI_sdf_cubic_to, 0, 0};
+	FT_Outline_Decompose((FT_Outline*)outline, &funcs, &shape);
+	_DNUI_sdf_end_contour(&shape);
+
+	int color = _DNUI_EDGE_WHITE;
+	for(int i = 0; i < shape.numContours; i++)
+	{
+		int start = shape.contours[i];
+		int end = i + 1 < shape.numContours ? shape.contours[i + 1] : shape.numEdges;
+		if(end > start)
+			_DNUI_sdf_color_contour(&shape.edges[start], end - start, &color);
+	}
+
+	int numSegments;
+	_DNUIsdfSegment* segments = _DNUI_sdf_flatten(&shape, &numSegments);
+
+	free(shape.edges);
+	free(shape.contours);
+
+	//truetype outlines wind clockwise, postscript outlines counterclockwise:
+	float sign = FT_Outline_Get_Orientation((FT_Outline*)outline) == FT_ORIENTATION_POSTSCRIPT ? -1.0f : 1.0f;
+	bool evenOdd = (outline->flags & FT_OUTLINE_EVEN_ODD_FILL) != 0;
+
+	//find each channel's distance for every pixel:
+	//---------------------------------
+	float* field = malloc((size_t)w * h * 3 * sizeof(float));
+
+	for(int y = 0; y < h; y++)
+	for(int x = 0; x < w; x++)
+	{
+		_DNUIsdfVec p = {left + x + 0.5f, top - y - 0.5f};
+		_DNUIsdfClosest closest[3];
+		for(int c = 0; c < 3; c++)
+			closest[c] = (_DNUIsdfClosest){-FLT_MAX, 1.0f, 0.0f, NULL};
+
+		int winding = 0;
+		for(int i = 0; i < numSegments; i++)
+		{
+			const _DNUIsdfSegment* segment = &segments[i];
+
+			float dist, ortho, param;
+			_DNUI_sdf_segment_distance(segment, p, &dist, &ortho, &param);
+			dist *= sign;
+
+			for(int c = 0; c < 3; c++)
+			{
+				if(!(segment->color & (1 << c)))
+					continue;
+
+				float absDist = fabsf(dist);
+				float closestDist = fabsf(closest[c].dist);
+				if(absDist < closestDist || (absDist == closestDist && ortho < closest[c].ortho))
+					closest[c] = (_DNUIsdfClosest){dist, ortho, param, segment};
+			}
+
+			//count crossings of a ray to the right of the pixel, to know whether it's really inside:
+			if((segment->a.y <= p.y) != (segment->b.y <= p.y))
+			{
+				float crossX = segment->a.x + (p.y - segment->a.y) * (segment->b.x - segment->a.x) / (segment->b.y - segment->a.y);
+				if(crossX > p.x)
+					winding += segment->b.y > segment->a.y ? 1 : -1;
+			}
+		}
+
+		float* out = &field[((size_t)y * w + x) * 3];
+		for(int c = 0; c < 3; c++)
+		{
+			float dist = closest[c].segment ? sign * _DNUI_sdf_pseudo_distance(&closest[c], p) : closest[c].dist;
+			out[c] = 0.5f + dist / (2.0f * DNUI_SDF_SPREAD);
+		}
+
+		//overlapping contours can give the wrong sign, flip the pixel if it disagrees with the fill rule:
+		bool inside = evenOdd ? (winding & 1) : winding != 0;
+		if((_DNUI_sdf_median(out[0], out[1], out[2]) > 0.5f) != inside)
+			for(int c = 0; c < 3; c++)
+				out[c] = 1.0f - out[c];
+	}
+
+	free(segments);
+
+	//flatten pixels that clash with a neighbour down to their median, so they don't create artifacts between them:
+	//---------------------------------
+	float threshold = DNUI_MSDF_CLASH_THRESHOLD / (2.0f * DNUI_SDF_SPREAD);
+	bool* clashes = calloc((size_t)w * h, sizeof(bool));
+
+	for(int y = 0; y < h; y++)
+	for(int x = 0; x < w; x++)
+	{
+		const float* a = &field[((size_t)y * w + x) * 3];
+		clashes[y * w + x] = (x > 0     && _DNUI_sdf_clash(a, a - 3, threshold)) ||
+		                     (x < w - 1 && _DNUI_sdf_clash(a, a + 3, threshold)) ||
+		                     (y > 0     && _DNUI_sdf_clash(a, a - w * 3, threshold)) ||
+		                     (y < h - 1 && _DNUI_sdf_clash(a, a + w * 3, threshold));
+	}
+
+	for(size_t i = 0; i < (size_t)w * h; i++)
+	{
+		float* out = &field[i * 3];
+		if(clashes[i])
+			out[0] = out[1] = out[2] = _DNUI_sdf_median(out[0], out[1], out[2]);
+	}
+
+	free(clashes);
+
+	//quantize:
+	//---------------------------------
+	for(size_t i = 0; i < (size_t)w * h * 3; i++)
+	{
+		float value = field[i] < 0.0f ? 0.0f : (field[i] > 1.0f ? 1.0f : field[i]);
+		pixels[i] = (unsigned char)(value * 255.0f + 0.5f);
+	}
+
+	free(field);
+}
+
+void _DNUI_generate_sdf(const FT_Outline* outline, int left, int top, int w, int h, unsigned char* pixels)
+{
+	//decompose outline into line segments:
+	//---------------------------------
+	_DNUIsdfShape shape = {0};
+	FT_Outline_Funcs funcs = {_DNUI_sdf_move_to, _DNUI_sdf_line_to, _DNUI_sdf_conic_to, _DNUI_sdf_cubic_to, 0, 0};
+	FT_Outline_Decompose((FT_Outline*)outline, &funcs, &shape);
+	_DNUI_sdf_end_contour(&shape);
+
+	int numSegments;
+	_DNUIsdfSegment* segments = _DNUI_sdf_flatten(&shape, &numSegments);
+
+	free(shape.edges);
+	free(shape.contours);
+
+	//sort segments into a grid of cells, each listing the segments within DNUI_SDF_SPREAD of it, so pixels only test nearby segments:
+	//---------------------------------
+	int cellsX = (w + DNUI_SDF_CELL_SIZE - 1) / DNUI_SDF_CELL_SIZE;
+	int cellsY = (h + DNUI_SDF_CELL_SIZE - 1) / DNUI_SDF_CELL_SIZE;
+	int numCells = cellsX * cellsY;
+
+	_DNUIsdfLine* lines = malloc((numSegments > 0 ? numSegments : 1) * sizeof(_DNUIsdfLine));
+	int* ranges = malloc((numSegments > 0 ? numSegments : 1) * 4 * sizeof(int)); //the first and last cell column and row each segment covers
+	int* cellStarts = calloc(numCells + 1, sizeof(int));                         //the index of each cell's first segment in cellSegments, followed by the total
+
+	for(int i = 0; i < numSegments; i++)
+	{
+		_DNUIsdfVec a = segments[i].a;
+		_DNUIsdfVec b = segments[i].b;
+		lines[i] = (_DNUIsdfLine){a.x, a.y, b.x - a.x, b.y - a.y, 1.0f / ((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y))};
+
+		//the pixels whose centers lie within DNUI_SDF_SPREAD of the segment's bounding box:
+		float minX = fminf(a.x, b.x) - DNUI_SDF_SPREAD - left - 0.5f;
+		float maxX = fmaxf(a.x, b.x) + DNUI_SDF_SPREAD - left - 0.5f;
+		float minY = top - 0.5f - fmaxf(a.y, b.y) - DNUI_SDF_SPREAD;
+		float maxY = top - 0.5f - fminf(a.y, b.y) + DNUI_SDF_SPREAD;
+
+		int* range = &ranges[i * 4];
+		range[0] = minX < 0.0f ? 0 : (int)minX / DNUI_SDF_CELL_SIZE;
+		range[1] = minY < 0.0f ? 0 : (int)minY / DNUI_SDF_CELL_SIZE;
+		range[2] = maxX < 0.0f ? -1 : ((int)maxX / DNUI_SDF_CELL_SIZE < cellsX ? (int)maxX / DNUI_SDF_CELL_SIZE : cellsX - 1);
+		range[3] = maxY < 0.0f ? -1 : ((int)maxY / DNUI_SDF_CELL_SIZE < cellsY ? (int)maxY / DNUI_SDF_CELL_SIZE : cellsY - 1);
+
+		for(int cellY = range[1]; cellY <= range[3]; cellY++)
+			for(int cellX = range[0]; cellX <= range[2]; cellX++)
+				cellStarts[cellY * cellsX + cellX + 1]++;
+	}
+
+	for(int i = 0; i < numCells; i++)
+		cellStarts[i + 1] += cellStarts[i];
+
+	int* cellSegments = malloc((cellStarts[numCells] > 0 ? cellStarts[numCells] : 1) * sizeof(int));
+	int* cellFill = malloc(numCells * sizeof(int));
+	memcpy(cellFill, cellStarts, numCells * sizeof(int));
+
+	for(int i = 0; i < numSegments; i++)
+	{
+		const int* range = &ranges[i * 4];
+		for(int cellY = range[1]; cellY <= range[3]; cellY++)
+			for(int cellX = range[0]; cellX <= range[2]; cellX++)
+				cellSegments[cellFill[cellY * cellsX + cellX]++] = i;
+	}
+
+	free(cellFill);
+	free(ranges);
+
+	//find the distance to the outline for every pixel, cell by cell:
+	//---------------------------------
+	size_t rowSize = (size_t)cellsX * DNUI_SDF_CELL_SIZE;
+	float* dists = malloc(rowSize * cellsY * DNUI_SDF_CELL_SIZE * sizeof(float));
+
+	for(int cellY = 0; cellY < cellsY; cellY++)
+	for(int cellX = 0; cellX < cellsX; cellX++)
+	{
+		float cellDists[DNUI_SDF_CELL_SIZE * DNUI_SDF_CELL_SIZE];
+		int cell = cellY * cellsX + cellX;
+		float x = left + cellX * DNUI_SDF_CELL_SIZE + 0.5f;
+		float y = top - cellY * DNUI_SDF_CELL_SIZE - 0.5f;
+		_DNUI_sdf_cell_distances(lines, &cellSegments[cellStarts[cell]], cellStarts[cell + 1] - cellStarts[cell], x, y, cellDists);
+
+		for(int row = 0; row < DNUI_SDF_CELL_SIZE; row++)
+			memcpy(&dists[(cellY * DNUI_SDF_CELL_SIZE + row) * rowSize + cellX * DNUI_SDF_CELL_SIZE], &cellDists[row * DNUI_SDF_CELL_SIZE], DNUI_SDF_CELL_SIZE * sizeof(float));
+	}
+
+	free(cellSegments);
+	free(cellStarts);
+	free(lines);
+
+	//sign each row by sweeping across the points where it crosses the outline, following the outline's fill rule:
+	//---------------------------------
+	bool evenOdd = (outline->flags & FT_OUTLINE_EVEN_ODD_FILL) != 0;
+	_DNUIsdfCrossing* crossings = malloc((numSegments > 0 ? numSegments : 1) * sizeof(_DNUIsdfCrossing));
+
+	for(int y = 0; y < h; y++)
+	{
+		float py = top - y - 0.5f;
+		int numCrossings = 0;
+		int winding = 0; //of a ray from the current pixel to the right
+		for(int i = 0; i < numSegments; i++)
+		{
+			const _DNUIsdfSegment* segment = &segments[i];
+			if((segment->a.y <= py) == (segment->b.y <= py))
+				continue;
+
+			float crossX = segment->a.x + (py - segment->a.y) * (segment->b.x - segment->a.x) / (segment->b.y - segment->a.y);
+			int dir = segment->b.y > segment->a.y ? 1 : -1;
+			crossings[numCrossings++] = (_DNUIsdfCrossing){crossX, dir};
+			winding += dir;
+		}
+
+		qsort(crossings, numCrossings, sizeof(_DNUIsdfCrossing), _DNUI_sdf_compare_crossings);
+
+		int next = 0;
+		for(int x = 0; x < w; x++)
+		{
+			float px = left + x + 0.5f;
+			while(next < numCrossings && crossings[next].x <= px)
+				winding -= crossings[next++].dir;
+
+			//quantize the same way as freetype, 128 on the outline and higher inside:
+			bool inside = evenOdd ? (winding & 1) : winding != 0;
+			float dist = dists[y * rowSize + x];
+			float value = 128.0f + (inside ? dist : -dist) * (128.0f / DNUI_SDF_SPREAD);
+			pixels[y * w + x] = (unsigned char)(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value + 0.5f));
+		}
+	}
+
+	free(crossings);
+	free(dists);
+	free(segments);
+}
\ No newline at end of file
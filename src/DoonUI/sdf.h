@@ -0,0 +1,74 @@
+#ifndef DNUI_SDF_H
+#define DNUI_SDF_H
+
+//signed distance field generation used internally by DNUI, not part of the public API
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <FreeType/ft2build.h>
+#include FT_FREETYPE_H
+
+#define DNUI_SDF_SPREAD 8 //the distance from a glyph's outline, in pixels, at which distance fields reach 0 or 1. matches FreeType's default for FT_RENDER_MODE_SDF
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+/* Computes the bitmap needed to hold a glyph's distance field, including DNUI_SDF_SPREAD pixels of padding on each side
+ * @param outline the glyph's outline, in 26.6 pixel coordinates
+ * @param left filled with the position of the bitmap's left edge, in pixels
+ * @param top filled with the position of the bitmap's top edge, in pixels
+ * @param w filled with the bitmap's width, 0 if the outline is empty
+ * @param h filled with the bitmap's height, 0 if the outline is empty
+ */
+void _DNUI_get_sdf_bounds(const FT_Outline* outline, int* left, int* top, int* w, int* h);
+/* Generates a single-channel signed distance field for a glyph, as an alternative to FreeType's FT_RENDER_MODE_SDF. The outline is flattened into line segments,
+ * which are sorted into a grid so each pixel only tests the segments near it, and distances are found for a row of pixels at once with SSE2 or AVX
+ * @param outline the glyph's outline, in 26.6 pixel coordinates
+ * @param left the position of the bitmap's left edge, in pixels
+ * @param top the position of the bitmap's top edge, in pixels
+ * @param w the bitmap's width
+ * @param h the bitmap's height
+ * @param pixels filled with the field, w * h pixels starting from the top row. Matches FreeType's output, 128 lies on the outline and higher values are inside
+ */
+void _DNUI_generate_sdf(const FT_Outline* outline, int left, int top, int w, int h, unsigned char* pixels);
+/* Generates a multi-channel signed distance field for a glyph. Each channel holds the distance to a different subset of the outline's edges,
+ * so the median of the three keeps corners sharp when the field is magnified
+ * @param outline the glyph's outline, in 26.6 pixel coordinates
+ * @param left the position of the bitmap's left edge, as returned by _DNUI_get_sdf_bounds()
+ * @param top the position of the bitmap's top edge, as returned by _DNUI_get_sdf_bounds()
+ * @param w the bitmap's width
+ * @param h the bitmap's height
+ * @param pixels filled with the field, w * h rgb pixels starting from the top row. 0.5 lies on the outline, higher values are inside
+ */
+void _DNUI_generate_msdf(const FT_Outline* outline, int left, int top, int w, int h, unsigned char* pixels);
+
+//--------------------------------------------------------------------------------------------------------------------------------//
+
+//a glyph's bitmap as rendered by _DNUI_render_glyph()
+typedef struct _DNUIrenderedGlyph
+{
+	float advance;
+	unsigned int w, h;
+	int l, t;
+	int pitch;             //the number of bytes between the start of each row
+	unsigned char* pixels; //points into the face's glyph slot, or is allocated if the field was generated by dnui
+	bool allocated;
+} _DNUIrenderedGlyph;
+
+/* Renders a glyph's distance field the way fonts are loaded, implemented in render.c
+ * @param face the face to render from, with its size already set
+ * @param glyphIndex the index of the glyph in the face
+ * @param flags the DNUI_FONT_* flags the font is loaded with, which choose the generator
+ * @param glyph filled with the glyph's metrics and field. pixels must be freed if allocated is set, otherwise it's overwritten by the face's next glyph
+ * @returns whether the glyph was loaded
+ */
+bool _DNUI_render_glyph(FT_Face face, FT_UInt glyphIndex, unsigned int flags, _DNUIrenderedGlyph* glyph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
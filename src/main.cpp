@@ -61,9 +61,6 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 void character_callback(GLFWwindow* window, unsigned int character)
 {
-	if(character > 128) //non-ASCII not supported
-		return;
-
 	dnui::Event charEvent = dnui::Event(dnui::Event::CHARACTER);
 	charEvent.character.character = character;
 	baseElement.handle_event(charEvent);
@@ -115,12 +112,13 @@ int main()
 	glfwSetCharCallback(window, character_callback);
 
 	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);  
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_MULTISAMPLE);
 
 	//initialize DNUI:
 	//---------------------------------
 	DNUI_init(windowW, windowH);
+	DNUI_set_premultiplied_alpha(true);
 	DNUIfont* arialFont = DNUI_load_font("arial.ttf", 72);
 
 	//create test layout:
@@ -223,11 +221,14 @@ int main()
 		//---------------------------------
 		glClearColor(0.0, 0.0, 0.0, 1.0);
 		glClear(GL_COLOR_BUFFER_BIT);
+		DNUI_begin_frame();
 
 		//render + draw ui:
 		//---------------------------------
 		baseElement.update(deltaTime, {0.0f, 0.0f}, {(float)windowW, (float)windowH});
+		DNUI_begin_text_batch();
 		baseElement.render(1.0f);
+		DNUI_end_text_batch();
 
 		//finish rendering and swap:
 		glfwSwapBuffers(window);
@@ -0,0 +1,99 @@
+#include "../DoonUI/render.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//bakes a font into a file that can be loaded with DNUI_load_baked_font(), so FreeType doesn't need to run when the program starts
+//usage: bakefont [--msdf] [--compressed] [--fast-sdf] <font.ttf> <size> <output> [codepoint or first-last]...
+//codepoints can be given in decimal or hex (0x...), printable ascii is baked if none are given. --msdf bakes multi-channel distance fields (DNUI_FONT_MSDF),
+//--compressed stores the atlas as rgtc1 blocks (DNUI_FONT_COMPRESSED), --fast-sdf generates the fields with dnui instead of freetype (DNUI_FONT_FAST_SDF)
+
+#define MAX_CODEPOINT 0x10FFFF
+
+int main(int argc, char** argv)
+{
+	unsigned int flags = 0;
+	while(argc > 1 && strncmp(argv[1], "--", 2) == 0)
+	{
+		if(strcmp(argv[1], "--msdf") == 0)
+			flags |= DNUI_FONT_MSDF;
+		else if(strcmp(argv[1], "--compressed") == 0)
+			flags |= DNUI_FONT_COMPRESSED;
+		else if(strcmp(argv[1], "--fast-sdf") == 0)
+			flags |= DNUI_FONT_FAST_SDF;
+		else
+		{
+			printf("ERROR - UNKNOWN OPTION \"%s\"\n", argv[1]);
+			return 1;
+		}
+
+		argv++;
+		argc--;
+	}
+
+	if(argc < 4)
+	{
+		printf("usage: bakefont [--msdf] [--compressed] [--fast-sdf] <font.ttf> <size> <output> [codepoint or first-last]...\n");
+		printf("example: bakefont arial.ttf 72 arial.dnuifont 0x20-0x7E 0x400-0x4FF\n");
+		return 1;
+	}
+
+	int size = atoi(argv[2]);
+	if(size <= 0)
+	{
+		printf("ERROR - INVALID SIZE \"%s\"\n", argv[2]);
+		return 1;
+	}
+
+	//parse codepoint ranges:
+	//---------------------------------
+	bool* included = calloc(MAX_CODEPOINT + 1, sizeof(bool)); //so codepoints in overlapping ranges are only baked once
+	int numCodepoints = 0;
+
+	if(argc == 4)
+	{
+		for(uint32_t i = 0x20; i <= 0x7E; i++)
+			included[i] = true;
+		numCodepoints = 0x7E - 0x20 + 1;
+	}
+
+	for(int i = 4; i < argc; i++)
+	{
+		char* end;
+		unsigned long first = strtoul(argv[i], &end, 0);
+		unsigned long last = first;
+		if(*end == '-')
+			last = strtoul(end + 1, &end, 0);
+
+		if(*end != '\0' || first > last || last > MAX_CODEPOINT)
+		{
+			printf("ERROR - INVALID CODEPOINT RANGE \"%s\"\n", argv[i]);
+			free(included);
+			return 1;
+		}
+
+		for(unsigned long j = first; j <= last; j++)
+		{
+			numCodepoints += !included[j];
+			included[j] = true;
+		}
+	}
+
+	uint32_t* codepoints = malloc(numCodepoints * sizeof(uint32_t));
+	int numAdded = 0;
+	for(uint32_t i = 0; i <= MAX_CODEPOINT; i++)
+		if(included[i])
+			codepoints[numAdded++] = i;
+
+	free(included);
+
+	//bake:
+	//---------------------------------
+	bool result = DNUI_bake_font(argv[1], size, flags, codepoints, numCodepoints, argv[3]);
+	if(result)
+		printf("baked %d codepoints of \"%s\" at size %d into \"%s\"\n", numCodepoints, argv[1], size, argv[3]);
+
+	free(codepoints);
+	return result ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "../DoonUI/render.h"
+#include "../DoonUI/sdf.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//compares DNUI's distance field generator (DNUI_FONT_FAST_SDF) against the default path fonts are loaded with (FreeType rasterizes each glyph,
+//then FT_RENDER_MODE_SDF converts the bitmap) on a font's printable ascii
+//usage: sdfbench <font.ttf> [size]...
+//sizes default to 32, 64 and 128. Both sides go through _DNUI_render_glyph(), so the time to load glyphs is included in both
+
+#define NUM_ROUNDS 3 //each size is timed this many times, keeping the fastest
+
+//a copy of a glyph's distance field
+typedef struct Field
+{
+	int w, h;
+	int l, t;
+	unsigned char* pixels;
+} Field;
+
+static double get_time()
+{
+	struct timespec time;
+	timespec_get(&time, TIME_UTC);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+//renders every glyph the way fonts loaded with flags are, returning the time taken in milliseconds. Fills fields with copies of the fields if not NULL
+static double render_glyphs(FT_Face face, unsigned int flags, Field* fields)
+{
+	double start = get_time();
+	for(int c = 32; c < 127; c++)
+	{
+		_DNUIrenderedGlyph glyph;
+		if(!_DNUI_render_glyph(face, FT_Get_Char_Index(face, c), flags, &glyph))
+			continue;
+
+		if(fields && glyph.pixels && glyph.w > 0 && glyph.h > 0)
+		{
+			Field* field = &fields[c];
+			*field = (Field){glyph.w, glyph.h, glyph.l, glyph.t, malloc((size_t)glyph.w * glyph.h)};
+			for(unsigned int y = 0; y < glyph.h; y++)
+				memcpy(&field->pixels[y * glyph.w], &glyph.pixels[y * glyph.pitch], glyph.w);
+		}
+
+		if(glyph.allocated)
+			free(glyph.pixels);
+	}
+
+	return get_time() - start;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		printf("usage: sdfbench <font.ttf> [size]...\n");
+		return 1;
+	}
+
+	FT_Library lib;
+	FT_Face face;
+	if(FT_Init_FreeType(&lib) || FT_New_Face(lib, argv[1], 0, &face))
+	{
+		printf("ERROR - FAILED TO LOAD FONT \"%s\"\n", argv[1]);
+		return 1;
+	}
+
+	int defaultSizes[] = {32, 64, 128};
+	int numSizes = argc > 2 ? argc - 2 : 3;
+
+	printf("%6s %12s %12s %8s %10s %10s %11s\n", "size", "freetype ms", "dnui ms", "speedup", "mean diff", "max diff", "mismatched");
+	for(int i = 0; i < numSizes; i++)
+	{
+		int size = argc > 2 ? atoi(argv[i + 2]) : defaultSizes[i];
+		if(size <= 0)
+		{
+			printf("ERROR - INVALID SIZE \"%s\"\n", argv[i + 2]);
+			continue;
+		}
+
+		FT_Set_Pixel_Sizes(face, 0, size);
+
+		//time:
+		//---------------------------------
+		double freetypeTime = 0.0;
+		double fastTime = 0.0;
+		for(int round = 0; round < NUM_ROUNDS; round++)
+		{
+			double time = render_glyphs(face, 0, NULL);
+			freetypeTime = round == 0 || time < freetypeTime ? time : freetypeTime;
+
+			time = render_glyphs(face, DNUI_FONT_FAST_SDF, NULL);
+			fastTime = round == 0 || time < fastTime ? time : fastTime;
+		}
+
+		//compare the fields, in 8 bit steps. Glyphs whose bitmaps don't line up are counted but not compared:
+		//---------------------------------
+		Field freetypeFields[127] = {0};
+		Field fastFields[127] = {0};
+		render_glyphs(face, 0, freetypeFields);
+		render_glyphs(face, DNUI_FONT_FAST_SDF, fastFields);
+
+		double totalDiff = 0.0;
+		size_t numPixels = 0;
+		int maxDiff = 0;
+		int numMismatched = 0;
+		for(int c = 32; c < 127; c++)
+		{
+			Field* freetypeField = &freetypeFields[c];
+			Field* fastField = &fastFields[c];
+			if(freetypeField->w != fastField->w || freetypeField->h != fastField->h || freetypeField->l != fastField->l || freetypeField->t != fastField->t)
+				numMismatched++;
+			else if(fastField->pixels)
+			{
+				size_t size = (size_t)fastField->w * fastField->h;
+				for(size_t j = 0; j < size; j++)
+				{
+					int diff = abs(fastField->pixels[j] - freetypeField->pixels[j]);
+					totalDiff += diff;
+					maxDiff = diff > maxDiff ? diff : maxDiff;
+				}
+
+				numPixels += size;
+			}
+
+			free(fastField->pixels);
+			free(freetypeField->pixels);
+		}
+
+		printf("%6d %12.2f %12.2f %7.1fx %10.3f %10d %11d\n", size, freetypeTime, fastTime, freetypeTime / fastTime, numPixels > 0 ? totalDiff / numPixels : 0.0, maxDiff, numMismatched);
+	}
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(lib);
+	return 0;
+}
\ No newline at end of file